@@ -0,0 +1,68 @@
+#pragma once
+
+#include "data/session_filter.h"
+#include "data/tick_data_store.h"
+#include "utils/types.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+// Timer ids fired by the engine at session boundaries (TimerEvent::timer_id)
+constexpr const char* kSessionStartTimer = "session_start";
+constexpr const char* kSessionEndTimer = "session_end";
+
+// Regular trading hours of one exchange at a fixed UTC offset. build()
+// expands them into dense open/close arrays, one entry per trading day;
+// a session id is the index into those arrays.
+class TradingCalendar {
+public:
+    TradingCalendar() = default;
+    TradingCalendar(std::string exchange, int utc_offset_minutes, TimeWindow hours,
+                    uint8_t weekday_mask = 0x3E);  // Mon-Fri
+
+    // Presets: NSE, BSE (IST); NYSE, NASDAQ (fixed -05:00, no DST); CRYPTO (24x7 UTC)
+    static TradingCalendar for_exchange(const std::string& exchange);
+
+    void add_holiday(const std::string& date);  // "YYYY-MM-DD"
+
+    // Precompute sessions for every trading day touching [first, last]
+    void build(Timestamp first, Timestamp last);
+
+    bool empty() const { return exchange_.empty(); }
+    const std::string& exchange() const { return exchange_; }
+    int utc_offset_minutes() const { return utc_offset_minutes_; }
+
+    size_t session_count() const { return open_ns_.size(); }
+    const std::vector<int64_t>& open_ns() const { return open_ns_; }
+    const std::vector<int64_t>& close_ns() const { return close_ns_; }
+    std::string session_date(size_t session) const;  // Local "YYYY-MM-DD"
+
+    // Session containing t, or -1 when the market is closed
+    int32_t session_of(int64_t epoch_ns) const;
+
+    // Session id per timestamp; one merge pass when times are sorted
+    std::vector<int32_t> assign_sessions(const Timestamp* times, size_t count) const;
+
+private:
+    std::string exchange_;
+    int utc_offset_minutes_ = 0;
+    TimeWindow hours_;
+    uint8_t weekday_mask_ = 0x3E;
+    std::vector<int64_t> holidays_;  // Local day numbers, sorted
+
+    std::vector<int64_t> open_ns_;   // UTC epoch ns, ascending
+    std::vector<int64_t> close_ns_;  // Exclusive: end of the last trading minute
+    std::vector<int64_t> session_day_;
+};
+
+// Per-instrument lookup tables derived from a built calendar
+struct SessionIndex {
+    std::vector<int32_t> session_of_tick;   // -1 outside trading hours
+    std::vector<TickRange> ticks_of_session;  // Indexed by session id; empty when no ticks
+
+    static SessionIndex build(const TradingCalendar& calendar, const TickDataStore::TickData& ticks);
+};
+
+} // namespace backtest
@@ -2,12 +2,27 @@
 
 #include "core/event_bus.h"
 #include "core/sim_clock.h"
+#include "core/timer_queue.h"
 #include "data/tick_data_store.h"
+#include "data/tick_archive.h"
+#include "data/intrabar_source.h"
+#include "data/session_filter.h"
+#include "calendar/trading_calendar.h"
 #include "execution/order_book.h"
 #include "execution/cost_model.h"
 #include "strategy/risk_manager.h"
 #include "utils/logging.h"
+#include "utils/memory_placement.h"
+#include "utils/perf_counters.h"
+#include "utils/config.h"
+#include "utils/run_arena.h"
+#include "utils/seqlock.h"
+#include <array>
+#include <chrono>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include <functional>
@@ -28,9 +43,36 @@ public:
     void initialize();
     
     // Load market data
-    void load_data(const std::string& filepath);
+    void load_data(const std::string& filepath, const InstrumentId& instrument = "AAPL");
     void add_tick_data(const InstrumentId& instrument, const std::vector<MarketDataTick>& ticks);
     
+    // Load every configured source, through the shared-memory cache when one is
+    // named, then place it as data.huge_pages / data.numa ask. With
+    // data.archive, only the archive's slice between data.from and data.to is
+    // read; CSV data is cut to that range after loading.
+    void load_data(const Config& config);
+    
+    // Partitioned archive (data/tick_archive.h): read the rows of instruments
+    // (empty = all) in [start_time, end_time], skipping partitions and blocks
+    // outside it by their metadata
+    TickArchive::ScanStats load_archive(const std::string& root, const std::vector<InstrumentId>& instruments,
+                                        Timestamp start_time, Timestamp end_time);
+    
+    // Move the loaded (read-only) data onto huge pages or NUMA-placed memory
+    void place_data(const MemoryPlacement& placement);
+    
+    // Multi-resolution mode: finer data for an instrument, read lazily for the
+    // bars a strategy asks about (StrategyBase::first_touch)
+    void add_intrabar_source(const InstrumentId& instrument, const std::string& path);
+    
+    // Columnar snapshots: write loaded data once, map it read-only elsewhere
+    void save_snapshot(const std::string& path) const;
+    void map_snapshot(const std::string& path);
+    
+    // Copy a prepared store in; columns viewing mapped memory are shared, not duplicated
+    void use_data(const TickDataStore& store);
+    const TickDataStore& get_data_store() const { return *data_store_; }
+    
     // Register strategies
     void add_strategy(std::unique_ptr<StrategyBase> strategy);
     
@@ -40,10 +82,45 @@ public:
     void configure_latency(Duration market_data_latency = std::chrono::microseconds(1),
                           Duration order_latency = std::chrono::microseconds(100));
     
+    // Exchange calendar: session_start/session_end timers and daily risk resets
+    void set_calendar(const TradingCalendar& calendar) { calendar_ = calendar; }
+    const TradingCalendar& get_calendar() const { return calendar_; }
+    const SessionIndex* get_session_index(const InstrumentId& instrument) const;
+    
+    // Apply cost, risk, latency and calendar sections (and intrabar files) of a typed config
+    void configure(const Config& config);
+    
     // Run backtest
     void run();
+    // Replace the data with its [start_time, end_time] slice and run it. After
+    // an archive load the slice is read from the archive, so ranges outside
+    // what was loaded work too.
     void run_range(Timestamp start_time, Timestamp end_time);
     
+    // Ticks per advance() call in run(); each call is one replay span in traces
+    static constexpr size_t kReplayBatch = 4096;
+    
+    // Stepwise run: run() is start(), advance() until it returns false, finish()
+    bool start();                     // False when there is no data or no strategy
+    bool advance(size_t max_ticks);   // Replays up to max_ticks; false once the data is exhausted
+    void finish();
+    size_t ticks_replayed() const { return replay_.delivered; }
+    
+    // Copy of a started engine at its current tick: strategies are cloned,
+    // risk state is copied, and market data, cost model and session tables
+    // are shared. Throws std::logic_error if a strategy cannot be cloned.
+    std::unique_ptr<BacktestEngine> fork() const;
+    const std::vector<std::unique_ptr<StrategyBase>>& get_strategies() const { return strategies_; }
+    
+    // Incremental re-runs. After a run, save_checkpoint() writes the causal
+    // strategies' state, the last rows they read back and how far each data
+    // file was read. load_checkpoint() replaces load_data(config): it restores
+    // that and reads only rows appended to the files since, returning their
+    // count; run() then continues where the checkpointed run stopped. Throws
+    // if the config, a strategy version or an already-read part of a file changed.
+    void save_checkpoint(const std::string& path) const;
+    size_t load_checkpoint(const std::string& path, const Config& config);
+    
     // Control execution
     void pause();
     void resume();
@@ -51,6 +128,12 @@ public:
     bool is_running() const { return is_running_; }
     
     // Get results
+    // Combined strategy P&L after a tick that changed it
+    struct EquityPoint {
+        Timestamp time;
+        Price pnl = 0.0;
+    };
+    
     struct BacktestResults {
         Timestamp start_time;
         Timestamp end_time;
@@ -69,7 +152,9 @@ public:
         Price sharpe_ratio = 0.0;
         
         std::unordered_map<StrategyId, Price> strategy_pnl;
+        std::vector<Price> session_pnl;  // By calendar session id; see get_calendar().session_date()
         std::vector<Fill> trade_history;
+        std::vector<EquityPoint> equity_curve;
         
         // Performance metrics
         Price win_rate() const {
@@ -109,7 +194,35 @@ public:
     void export_summary_json(const std::string& filepath) const;
     void generate_report_markdown(const std::string& filepath) const;
     
-    // Real-time monitoring
+    // Real-time monitoring. The replay publishes a ProgressSnapshot every
+    // `ticks` replayed ticks and every `sim_time` of simulated time (zero
+    // disables either), plus a final one from finish() with done set. Other
+    // threads read progress() without locking; the replay never waits for them.
+    struct ProgressSnapshot {
+        uint64_t ticks_replayed = 0;
+        uint64_t total_ticks = 0;   // Ticks inside some route's ranges
+        int64_t sim_time_ns = 0;    // Timestamp of the last replayed tick
+        double pnl = 0.0;           // Strategies' P&L, i.e. equity less initial capital
+        double peak_pnl = 0.0;
+        double max_drawdown = 0.0;  // Largest fall from peak_pnl
+        uint64_t trades = 0;
+        uint64_t data_bytes = 0;         // Market data held by the store
+        uint64_t arena_spill_bytes = 0;  // Run containers that outgrew the RunArena block
+        uint64_t done = 0;
+        
+        double fraction() const {
+            return total_ticks ? static_cast<double>(ticks_replayed) / static_cast<double>(total_ticks) : 0.0;
+        }
+    };
+    void set_progress_interval(size_t ticks, Duration sim_time);
+    const SeqLock<ProgressSnapshot>& progress() const { return progress_; }
+    
+    // Feed the progress and update callbacks from progress() every period on
+    // a thread of their own, so they never run on the replay thread. Stops
+    // after the final snapshot, or with stop_progress_monitor().
+    void start_progress_monitor(std::chrono::milliseconds period);
+    void stop_progress_monitor();
+    
     void set_progress_callback(std::function<void(double)> callback) {
         progress_callback_ = callback;
     }
@@ -119,24 +232,41 @@ public:
     }
     
     // Statistics
+    enum class Stage : size_t { Load, Setup, Replay, Finish };
+    static constexpr size_t kStageCount = 4;
+    static const char* stage_name(Stage stage);
+    
     struct EngineStats {
-        size_t events_processed = 0;
+        size_t events_processed = 0;  // Ticks replayed
         size_t orders_submitted = 0;
         size_t orders_filled = 0;
         size_t orders_rejected = 0;
-        Duration total_processing_time;
+        Duration total_processing_time{0};  // start() to finish()
         double events_per_second = 0.0;
+        // Counts per stage while enable_perf_counters() is on; divide by
+        // events_processed for per-tick figures
+        std::array<PerfCounters::Reading, kStageCount> stage_counters{};
     };
     
     const EngineStats& get_stats() const { return stats_; }
     
+    // Read hardware counters (utils/perf_counters.h) around load_data(config),
+    // start(), advance() and finish() on the calling thread. Off by default;
+    // perf_counters()->has() tells which events the kernel granted.
+    void enable_perf_counters(bool enable);
+    const PerfCounters* perf_counters() const { return perf_.get(); }
+    
 private:
+    // Run-local containers below allocate from here; declared first so it outlives them.
+    // Anything shared with forks (data, session tables) stays on the heap.
+    RunArena arena_;
+    
     // Core components
     std::unique_ptr<EventBus> event_bus_;
     std::shared_ptr<SimClock> sim_clock_;
-    std::unique_ptr<TickDataStore> data_store_;
+    std::shared_ptr<TickDataStore> data_store_;  // Shared with forks; copied before any write
     std::unique_ptr<RiskManager> risk_manager_;
-    std::unique_ptr<CostModel> cost_model_;
+    std::shared_ptr<CostModel> cost_model_;
     std::unique_ptr<ExecutionHandler> execution_handler_;
     std::unique_ptr<OrderRouter> order_router_;
     
@@ -145,6 +275,75 @@ private:
     
     // Strategies
     std::vector<std::unique_ptr<StrategyBase>> strategies_;
+    std::unordered_map<InstrumentId, std::shared_ptr<const IntrabarSource>> intrabar_;
+    
+    // Routing table: dense instrument index -> subscribed strategies and their slots
+    struct MarketRoute {
+        StrategyBase* strategy;
+        size_t slot;
+        const std::vector<TickRange>* ranges;  // In-session (and warm-up) ticks for this strategy
+        int64_t conflation_ns;  // StrategyBase::conflation(); 0 delivers every tick
+        size_t strategy_index;  // Into strategies_ and strategy_pnl_seen_
+    };
+    std::vector<InstrumentId> route_instruments_;
+    using RouteList = std::pmr::vector<MarketRoute>;
+    std::pmr::vector<RouteList> routes_{arena_.resource()};
+    std::pmr::vector<std::pmr::vector<TickRange>> route_spans_{arena_.resource()};  // Union of the routes' ranges per instrument
+    std::unordered_map<std::string, std::shared_ptr<const std::vector<TickRange>>> session_ranges_;  // instrument|session key
+    TimerQueue timers_{arena_.resource()};  // Strategy timers; lanes indexed like route_instruments_
+    
+    // Calendar sessions, built with the routes; indexed like route_instruments_
+    TradingCalendar calendar_;
+    std::shared_ptr<const std::vector<SessionIndex>> session_indexes_;
+    Price session_start_pnl_ = 0.0;
+    // Sessions whose daily risk counters were reset. Instruments replay one
+    // after another and each walks the sessions again; only the first start counts.
+    std::vector<bool> risk_reset_sessions_;
+    
+    // Rows of a route not yet delivered because of market data latency or
+    // conflation: from first_row, next conflated update due at ready_ns
+    struct PendingRows {
+        size_t first_row = 0;
+        int64_t ready_ns = std::numeric_limits<int64_t>::min();
+    };
+    // Replay position, so a run can stop between ticks and resume (or fork)
+    struct ReplayCursor {
+        explicit ReplayCursor(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+            : route_cursors(memory), route_pending(memory) {}
+        size_t instrument = 0;
+        size_t span = 0;
+        size_t tick = 0;
+        int32_t session = -1;
+        std::pmr::vector<size_t> route_cursors;  // Per route of the instrument: index into its ranges
+        std::pmr::vector<PendingRows> route_pending;  // Per route: rows not yet delivered
+        size_t visible = 0;  // Rows of the instrument strategies can see by now
+        size_t delivered = 0;
+        int64_t now_ns = 0;  // Timestamp of the tick last delivered
+    };
+    ReplayCursor replay_{arena_.resource()};
+    // Events handed to strategies, rewritten for each row so delivering a
+    // tick does not allocate: one for undelayed routes, one for delayed ones.
+    // Scratch, not carried into forks.
+    MarketEvent tick_event_{MarketDataTick{}};
+    MarketEvent delayed_event_{MarketDataTick{}};
+    
+    // Checkpoint bookkeeping: how far each CSV was read, and on a resumed
+    // run the restored state and the carried-over rows not to replay again
+    struct SourceProgress {
+        std::string path;
+        InstrumentId instrument;
+        uint64_t offset = 0;    // Bytes consumed, always at a line end
+        std::string last_line;  // Detects a file rewritten since
+    };
+    std::vector<SourceProgress> sources_;
+    std::string archive_root_;  // Last archive loaded, for run_range()
+    std::vector<InstrumentId> archive_instruments_;
+    uint64_t config_hash_ = 0;
+    int64_t sessions_first_ns_ = std::numeric_limits<int64_t>::max();  // Calendar start of the whole chain
+    std::unordered_map<InstrumentId, size_t> resume_rows_;
+    std::unordered_map<StrategyId, std::pair<std::string, std::vector<char>>> resume_states_;  // version, state
+    std::vector<Price> resume_session_pnl_;
+    std::vector<EquityPoint> resume_equity_curve_;
     
     // State
     std::atomic<bool> is_running_{false};
@@ -153,12 +352,48 @@ private:
     
     // Results and statistics
     BacktestResults results_;
+    // Equity curve of the run in progress, which finish() joins into results_.
+    // fork() seals the points so far into an immutable segment that parent
+    // and copy both chain from, so forking never copies the curve; each
+    // engine then appends to its own tail. Mutable because sealing does not
+    // change the curve.
+    struct EquitySegment {
+        EquitySegment(std::shared_ptr<const EquitySegment> before, std::vector<EquityPoint> sealed);
+        ~EquitySegment();
+        mutable std::shared_ptr<const EquitySegment> previous;  // Released iteratively, see the destructor
+        std::vector<EquityPoint> points;
+        size_t total = 0;  // Points here and in every earlier segment
+    };
+    mutable std::shared_ptr<const EquitySegment> equity_sealed_;
+    mutable std::vector<EquityPoint> equity_tail_;
+    Price equity_last_pnl_ = 0.0;  // Last point's P&L; 0 before the first
+    // Each strategy's P&L when last read, and their sum. A strategy's P&L only
+    // moves when it runs, so a tick re-reads just its instrument's routes.
+    std::vector<Price> strategy_pnl_seen_;
+    Price pnl_seen_ = 0.0;
     EngineStats stats_;
+    std::unique_ptr<PerfCounters> perf_;  // Not carried into forks
+    std::chrono::steady_clock::time_point run_started_;
+    PerfCounters::Reading perf_read() const { return perf_ ? perf_->read() : PerfCounters::Reading{}; }
+    void perf_add(Stage stage, const PerfCounters::Reading& since) {
+        if (perf_) stats_.stage_counters[static_cast<size_t>(stage)] += perf_->read() - since;
+    }
     
     // Callbacks
     std::function<void(double)> progress_callback_;
     std::function<void(const BacktestResults&)> update_callback_;
     
+    // Progress publishing: the next tick count and simulated time that trigger
+    // update_progress(); max() when that interval is off
+    SeqLock<ProgressSnapshot> progress_;
+    size_t progress_every_ticks_ = 0;
+    int64_t progress_every_ns_ = 0;
+    size_t progress_due_tick_ = std::numeric_limits<size_t>::max();
+    int64_t progress_due_ns_ = std::numeric_limits<int64_t>::max();
+    ProgressSnapshot progress_state_;  // Writer's copy; drawdown accumulates as equity points are added
+    std::thread progress_monitor_;
+    std::atomic<bool> progress_monitor_stop_{false};
+    
     // Latency settings
     Duration market_data_latency_{std::chrono::microseconds(1)};
     Duration order_latency_{std::chrono::microseconds(100)};
@@ -180,9 +415,24 @@ private:
     // Simulation control
     void advance_time_to(Timestamp target_time);
     void update_results();
-    void update_progress();
+    void update_progress(int64_t now_ns, bool done = false);
     
     // Initialization helpers
+    TickDataStore& mutable_store();
+    void read_csv(const std::string& filepath, const InstrumentId& instrument, uint64_t offset);
+    void read_sources(const Config& config);
+    void restore_strategy(StrategyBase& strategy);
+    bool replay(size_t max_ticks);
+    void enter_instrument(size_t index);
+    void deliver_tick(size_t index, size_t tick_index);
+    void deliver_delayed(size_t index, size_t route, const TickRange& range, size_t tick_index, int64_t now_ns);
+    void build_routes();
+    void build_sessions();
+    void start_session(int32_t session, const RouteList& routes);
+    void end_session(int32_t session, const RouteList& routes);
+    Price strategies_pnl() const;
+    size_t equity_points() const;
+    std::vector<EquityPoint> joined_equity_curve() const;
     void setup_event_handlers();
     void create_order_books();
     void validate_configuration();
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "utils/types.h"
+#include <cstdint>
+
+namespace backtest {
+
+// Which of several events at the same timestamp comes first. The replay
+// follows the same order within a tick: session boundaries, then timers,
+// then market data.
+enum class EventClass : uint8_t {
+    Session = 0,
+    Timer = 1,
+    MarketData = 2,
+    Signal = 3,
+    Order = 4,
+    Fill = 5,
+    Risk = 6,
+};
+
+// Total order on (timestamp, event class, instrument index, sequence) packed
+// into one 128-bit unsigned integer, so comparing two keys is a single
+// integer compare. The high word is the timestamp with its sign bit flipped;
+// the low word holds the class (8 bits), the dense instrument index (24 bits,
+// sorted by instrument ID) and an insertion sequence (32 bits). SimClock
+// orders its scheduled events by it.
+class EventKey {
+public:
+    static constexpr uint32_t kMaxInstrument = (1u << 24) - 1;
+
+    constexpr EventKey() = default;
+    constexpr EventKey(int64_t time_ns, EventClass cls, uint32_t instrument, uint32_t sequence)
+        : EventKey(static_cast<uint64_t>(time_ns) ^ (uint64_t{1} << 63),
+                   (uint64_t{static_cast<uint8_t>(cls)} << 56) |
+                       (uint64_t{instrument & kMaxInstrument} << 32) | sequence) {}
+
+#if defined(__SIZEOF_INT128__)
+    constexpr bool operator<(const EventKey& other) const { return value_ < other.value_; }
+    constexpr bool operator>(const EventKey& other) const { return value_ > other.value_; }
+
+private:
+    constexpr EventKey(uint64_t high, uint64_t low) : value_((static_cast<unsigned __int128>(high) << 64) | low) {}
+    unsigned __int128 value_ = 0;
+#else
+    // Compilers without a 128-bit integer (MSVC) compare the two words
+    constexpr bool operator<(const EventKey& other) const {
+        return high_ != other.high_ ? high_ < other.high_ : low_ < other.low_;
+    }
+    constexpr bool operator>(const EventKey& other) const { return other < *this; }
+
+private:
+    constexpr EventKey(uint64_t high, uint64_t low) : high_(high), low_(low) {}
+    uint64_t high_ = 0;
+    uint64_t low_ = 0;
+#endif
+};
+
+} // namespace backtest
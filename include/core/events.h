@@ -1,7 +1,9 @@
 #pragma once
 
 #include "utils/types.h"
+#include <limits>
 #include <memory>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -18,6 +20,9 @@ public:
     EventType type() const { return type_; }
     Timestamp timestamp() const { return timestamp_; }
     
+protected:
+    void set_timestamp(Timestamp timestamp) { timestamp_ = timestamp; }
+    
 private:
     EventType type_;
     Timestamp timestamp_;
@@ -31,6 +36,14 @@ public:
     
     const MarketDataTick& tick() const { return tick_; }
     
+    // Rewrite the tick in place for the next row. The replay loop reuses one
+    // event this way so the tick's strings keep their capacity.
+    template<typename Write>
+    void rewrite(Write&& write) {
+        write(tick_);
+        set_timestamp(tick_.timestamp);
+    }
+    
 private:
     MarketDataTick tick_;
 };
@@ -114,17 +127,28 @@ private:
     std::string message_;
 };
 
-// Timer event for scheduled operations
+// Timer event for scheduled operations: either a named engine timer
+// (kSessionStartTimer, ...) or a recurring strategy timer by handle
 class TimerEvent : public Event {
 public:
-    explicit TimerEvent(const std::string& timer_id,
+    static constexpr TimerHandle kNoHandle = std::numeric_limits<TimerHandle>::max();
+    
+    // timer_id is a string literal such as kSessionStartTimer; std::string
+    // does not convert, so the event cannot point into a temporary
+    explicit TimerEvent(const char* timer_id,
                        Timestamp timestamp = std::chrono::high_resolution_clock::now())
         : Event(EventType::TIMER, timestamp), timer_id_(timer_id) {}
+    TimerEvent(TimerHandle handle, Timestamp timestamp)
+        : Event(EventType::TIMER, timestamp), handle_(handle) {}
     
-    const std::string& timer_id() const { return timer_id_; }
+    // Empty for handle timers
+    std::string_view timer_id() const { return timer_id_; }
+    // kNoHandle for named timers
+    TimerHandle handle() const { return handle_; }
     
 private:
-    std::string timer_id_;
+    const char* timer_id_ = "";
+    TimerHandle handle_ = kNoHandle;
 };
 
 // Event pointer type
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/engine.h"
+#include "utils/config.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace backtest {
+
+// Content-addressed store of finished runs. A key hashes the loaded data,
+// the contents of any intrabar files, the resolved config and the strategy's
+// version(), so changing any of them misses instead of serving stale
+// results. One small binary file per key: the summary, per-strategy and
+// per-session P&L and the equity curve; trade history is not kept.
+class ResultCache {
+public:
+    explicit ResultCache(std::string directory);
+
+    static uint64_t key(const TickDataStore& store, const Config& config, const std::string& strategy_version);
+
+    std::optional<BacktestEngine::BacktestResults> lookup(uint64_t key) const;
+    void store(uint64_t key, const BacktestEngine::BacktestResults& results) const;
+
+    // Drop one entry (false if there was none) or every entry (count removed)
+    bool invalidate(uint64_t key) const;
+    size_t clear() const;
+
+    const std::string& directory() const { return directory_; }
+    std::string path_for(uint64_t key) const;
+
+private:
+    std::string directory_;
+};
+
+} // namespace backtest
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/event_order.h"
+#include "utils/time_utils.h"
 #include "utils/types.h"
 #include <queue>
 #include <functional>
@@ -10,13 +12,15 @@
 
 namespace backtest {
 
-// Event scheduling for time-based operations
+// Event scheduling for time-based operations; ties on time run in EventKey
+// order (class, instrument, then scheduling order), never heap order
 struct ScheduledEvent {
     Timestamp execution_time;
+    EventKey key;
     std::function<void()> callback;
     
     bool operator>(const ScheduledEvent& other) const {
-        return execution_time > other.execution_time;
+        return key > other.key;
     }
 };
 
@@ -46,14 +50,17 @@ public:
     }
     
     // Schedule a callback for future execution
-    void schedule(Timestamp execution_time, std::function<void()> callback) {
+    void schedule(Timestamp execution_time, std::function<void()> callback,
+                  EventClass event_class = EventClass::Timer, uint32_t instrument = 0) {
         std::lock_guard<std::mutex> lock(mutex_);
-        scheduled_events_.emplace(ScheduledEvent{execution_time, std::move(callback)});
+        EventKey key(TimeUtils::to_epoch_ns(execution_time), event_class, instrument, next_sequence_++);
+        scheduled_events_.emplace(ScheduledEvent{execution_time, key, std::move(callback)});
     }
     
     // Schedule with delay from current time
-    void schedule_delay(Duration delay, std::function<void()> callback) {
-        schedule(now() + delay, std::move(callback));
+    void schedule_delay(Duration delay, std::function<void()> callback,
+                        EventClass event_class = EventClass::Timer, uint32_t instrument = 0) {
+        schedule(now() + delay, std::move(callback), event_class, instrument);
     }
     
     // Reset clock to new time
@@ -64,6 +71,7 @@ public:
         while (!scheduled_events_.empty()) {
             scheduled_events_.pop();
         }
+        next_sequence_ = 0;
     }
     
     // Check if there are pending scheduled events
@@ -102,6 +110,7 @@ private:
     
     mutable std::mutex mutex_;
     Timestamp current_time_;
+    uint32_t next_sequence_ = 0;
     std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>, std::greater<ScheduledEvent>> scheduled_events_;
 };
 
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "utils/types.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+namespace backtest {
+
+class StrategyBase;
+
+// Recurring timers of a run, kept per replay lane (the engine's route
+// instrument index), since the replay advances time one instrument at a time.
+// Timers of a lane that are due at the same time share one bucket in a
+// min-heap, so firing a batch costs one heap pop plus one delivery per timer,
+// and rescheduling reuses the bucket's storage. A timer fires on the lane's
+// first tick at or after its due time; occurrences that fall between two
+// ticks fire once, stamped with the latest of them.
+class TimerQueue {
+public:
+    static constexpr size_t kNoLane = std::numeric_limits<size_t>::max();
+
+    struct Timer {
+        StrategyBase* strategy;
+        size_t slot;
+        size_t lane;
+        int64_t period_ns;
+        bool active;
+    };
+
+    explicit TimerQueue(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : timers_(memory), lanes_(memory), spare_(memory) {}
+    
+    // Drop every timer and size the queue for a new set of lanes
+    void reset(size_t lanes);
+
+    // First due at first_ns, then every period_ns. A timer on kNoLane (an
+    // instrument without data) gets a handle but never fires.
+    TimerHandle add(StrategyBase* strategy, size_t slot, size_t lane, int64_t first_ns, int64_t period_ns);
+    void cancel(TimerHandle handle);
+    const Timer& timer(TimerHandle handle) const { return timers_.at(handle); }
+
+    int64_t next_due_ns(size_t lane) const {
+        const auto& heap = lanes_[lane];
+        return heap.empty() ? std::numeric_limits<int64_t>::max() : heap.front().due_ns;
+    }
+
+    // Calls fire(timer, handle, occurrence_ns) for every active timer of lane
+    // due at or before now_ns and reschedules it past now_ns. fire may add or
+    // cancel timers.
+    template <typename Fire>
+    void fire_due(size_t lane, int64_t now_ns, Fire&& fire) {
+        auto& heap = lanes_[lane];
+        while (!heap.empty() && heap.front().due_ns <= now_ns) {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            Bucket bucket = std::move(heap.back());
+            heap.pop_back();
+            for (TimerHandle handle : bucket.timers) {
+                const Timer timer = timers_[handle];  // fire may grow timers_
+                if (!timer.active) continue;
+                const int64_t occurrence = bucket.due_ns + (now_ns - bucket.due_ns) / timer.period_ns * timer.period_ns;
+                fire(timer, handle, occurrence);
+                if (timers_[handle].active) schedule(lane, occurrence + timer.period_ns, handle);
+            }
+            bucket.timers.clear();
+            spare_.push_back(std::move(bucket.timers));
+        }
+    }
+
+    // Point timers of one strategy at another (BacktestEngine::fork)
+    void retarget(const StrategyBase* from, StrategyBase* to);
+
+private:
+    struct Bucket {
+        int64_t due_ns;
+        std::pmr::vector<TimerHandle> timers;
+    };
+    static bool later(const Bucket& a, const Bucket& b) { return a.due_ns > b.due_ns; }
+    void schedule(size_t lane, int64_t due_ns, TimerHandle handle);
+
+    std::pmr::vector<Timer> timers_;  // by handle
+    std::pmr::vector<std::pmr::vector<Bucket>> lanes_;  // Min-heaps on due_ns
+    std::pmr::vector<std::pmr::vector<TimerHandle>> spare_;  // Storage of fired buckets
+};
+
+} // namespace backtest
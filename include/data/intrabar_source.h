@@ -0,0 +1,28 @@
+#pragma once
+
+#include "utils/types.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+// Finer-grained data (second bars or ticks in the bar CSV format) for one
+// instrument, read on demand. Nothing is loaded up front: each query
+// binary-searches the time-sorted file by byte offset and reads only the
+// rows of the requested interval, so just the bars that need them pay.
+class IntrabarSource {
+public:
+    IntrabarSource(std::string path, InstrumentId instrument);
+
+    // Rows with from_ns <= time < to_ns, in file order
+    std::vector<MarketDataTick> rows_between(int64_t from_ns, int64_t to_ns) const;
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    InstrumentId instrument_;
+};
+
+} // namespace backtest
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "data/tick_data_store.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace backtest {
+
+// Wall-clock window in exchange local time, minutes from midnight, inclusive
+struct TimeWindow {
+    int start_minute = 0;
+    int end_minute = 24 * 60 - 1;
+
+    bool contains(int minute) const { return minute >= start_minute && minute <= end_minute; }
+};
+
+// When a strategy is active: time windows on trading days of a simple
+// calendar (weekday mask plus holiday dates). Parsed from text such as
+//
+//   "mon-fri 09:15-15:30"   or   "09:15-11:30,13:00-15:30"
+struct SessionSpec {
+    std::vector<TimeWindow> windows;    // Empty means the whole day
+    uint8_t weekday_mask = 0x7F;        // Bit 0 = Sunday ... bit 6 = Saturday
+    std::vector<std::string> holidays;  // "YYYY-MM-DD" dates with no session
+    size_t warmup_ticks = 0;            // Ticks before each active range fed as warm-up
+
+    static SessionSpec parse(const std::string& text);
+
+    bool is_unrestricted() const { return windows.empty() && weekday_mask == 0x7F && holidays.empty(); }
+    bool is_active(std::string_view date) const;
+
+    // Canonical text, used to share precomputed ranges between strategies
+    std::string key() const;
+};
+
+// Half-open tick index range; warm-up ranges feed history but not trading
+struct TickRange {
+    size_t begin = 0;
+    size_t end = 0;
+    bool warmup = false;
+};
+
+namespace SessionFilter {
+
+// One pass over the date column: ordered, non-overlapping delivery ranges
+std::vector<TickRange> build_ranges(const TickDataStore::TickData& ticks, const SessionSpec& spec);
+
+// Union of several range lists; a merged range is warm-up only if all its parts are
+std::vector<TickRange> merge(const std::vector<const std::vector<TickRange>*>& lists);
+
+} // namespace SessionFilter
+
+} // namespace backtest
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "data/tick_data_store.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace backtest {
+
+// Named shared-memory segment holding one TickSnapshot image (columns plus
+// symbol table) for every nemo process on the host. The first process to ask
+// for a name loads the data and publishes it; later ones map it read-only.
+// Each attached store holds one reference; the last to detach unlinks it.
+// A process that crashes keeps its reference, so the segment outlives it;
+// the fingerprint of the data sources stored with it keeps a later run
+// from reading such a segment as its own data, and remove() clears it.
+// Attachers wait for a publisher only while its process is alive.
+//
+//   ControlBlock | pad to 64 | TickSnapshot image
+namespace SharedTickCache {
+
+constexpr char kMagic[8] = {'N', 'E', 'M', 'O', 'S', 'H', 'M', '2'};
+
+// Attach to an existing segment; returns false if name is not published.
+// Throws if it was published with another fingerprint.
+bool attach(const std::string& name, uint64_t fingerprint, TickDataStore& store);
+
+// Attach if name exists, otherwise build source with loader, publish it
+// under name and attach store to the published copy. fingerprint identifies
+// the data sources (see BacktestEngine::load_data); a segment published with
+// another one is refused.
+void attach_or_publish(const std::string& name, uint64_t fingerprint,
+                       const std::function<void(TickDataStore&)>& loader,
+                       TickDataStore& store);
+
+// Live references, or -1 if name is not published
+int32_t reference_count(const std::string& name);
+
+// Unlink a segment regardless of references (cleanup after crashed processes)
+void remove(const std::string& name);
+
+} // namespace SharedTickCache
+
+} // namespace backtest
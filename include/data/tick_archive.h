@@ -0,0 +1,100 @@
+#pragma once
+
+#include "data/tick_data_store.h"
+#include "data/tick_snapshot.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+// Partitioned on-disk tick archive for data sets too large to load whole.
+// One file per instrument and UTC day:
+//
+//   <root>/<instrument>/<YYYY>/<YYYY-MM-DD>.part
+//
+// A partition holds its rows in time order, cut into blocks of columns (the
+// TickSnapshot column set), followed by a footer and a fixed-size trailer:
+//
+//   Block[block_count] | PartitionFooter | BlockInfo[block_count] | Trailer
+//
+// Footer and block entries carry row counts, the time range and min/max of
+// every value column, so a query skips instruments, years and days by path
+// and blocks by their time range without reading any rows.
+namespace TickArchive {
+
+constexpr char kMagic[8] = {'N', 'E', 'M', 'O', 'P', 'A', 'R', 'T'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kDefaultBlockRows = 65536;
+
+// Columns with min/max statistics: BID_PRICES through CLOSE
+constexpr uint32_t kFirstValueColumn = TickSnapshot::BID_PRICES;
+constexpr uint32_t kValueColumns = TickSnapshot::CLOSE - TickSnapshot::BID_PRICES + 1;
+
+struct ColumnRange {
+    double min = 0.0;
+    double max = 0.0;
+};
+
+struct BlockInfo {
+    uint64_t offset;      // File offset of the block, 8-byte aligned
+    uint64_t bytes;
+    uint64_t rows;
+    uint64_t date_chars;
+    int64_t first_ns;     // Time range of the block's rows
+    int64_t last_ns;
+    ColumnRange ranges[kValueColumns];
+};
+
+struct PartitionFooter {
+    uint64_t rows;
+    int64_t first_ns;
+    int64_t last_ns;
+    uint32_t block_count;
+    uint32_t reserved;
+    ColumnRange ranges[kValueColumns];
+};
+
+struct Trailer {
+    uint64_t footer_offset;
+    uint32_t version;
+    uint32_t reserved;
+    char magic[8];
+};
+
+// Instruments (empty = every instrument in the archive) and an inclusive
+// time range in UTC nanoseconds
+struct Query {
+    std::vector<InstrumentId> instruments;
+    int64_t from_ns = std::numeric_limits<int64_t>::min();
+    int64_t to_ns = std::numeric_limits<int64_t>::max();
+};
+
+struct ScanStats {
+    size_t partitions_read = 0;     // Footers opened
+    size_t partitions_skipped = 0;  // Opened, then pruned by the footer's time range
+    size_t blocks_read = 0;
+    size_t blocks_skipped = 0;
+    size_t rows = 0;
+    size_t bytes_read = 0;
+};
+
+// root/instrument/YYYY/YYYY-MM-DD.part for a day number
+std::string partition_path(const std::string& root, const InstrumentId& instrument, int64_t day);
+
+// Write store's rows as day partitions under root, replacing any partition
+// of the same instrument and day; rows sharing a timestamp keep their order.
+// Returns the number of partitions written.
+size_t write(const TickDataStore& store, const std::string& root, size_t block_rows = kDefaultBlockRows);
+
+// Append the rows matching query to store, reading only the blocks that
+// overlap its time range. Throws if a partition is truncated or corrupt.
+ScanStats load(const std::string& root, const Query& query, TickDataStore& store);
+
+// Footer of one partition file
+PartitionFooter read_footer(const std::string& path, std::vector<BlockInfo>* blocks = nullptr);
+
+} // namespace TickArchive
+
+} // namespace backtest
@@ -1,31 +1,201 @@
 #pragma once
 
 #include "utils/types.h"
+#include "utils/hash.h"
+#include "utils/trace.h"
 #include <vector>
 #include <memory>
 #include <algorithm>
 #include <unordered_map>
 #include <span>
 #include <numeric>
+#include <string_view>
 
 namespace backtest {
 
+// Column of trivially copyable values that either owns its storage or views
+// read-only memory owned elsewhere (memory-mapped snapshots, shared segments).
+// Mutating a view copies it into owned storage first.
+template<typename T>
+class Column {
+public:
+    using value_type = T;
+    
+    Column() = default;
+    Column(const Column& other) { *this = other; }
+    Column(Column&& other) noexcept { *this = std::move(other); }
+    
+    Column& operator=(const Column& other) {
+        if (this == &other) return *this;
+        owned_ = other.owned_;
+        view_ = other.view_;
+        if (view_) {
+            data_ = other.data_;
+            size_ = other.size_;
+        } else {
+            sync();
+        }
+        return *this;
+    }
+    
+    Column& operator=(Column&& other) noexcept {
+        owned_ = std::move(other.owned_);
+        view_ = other.view_;
+        if (view_) {
+            data_ = other.data_;
+            size_ = other.size_;
+        } else {
+            sync();
+        }
+        other.reset_view();
+        return *this;
+    }
+    
+    Column& operator=(std::vector<T>&& values) {
+        owned_ = std::move(values);
+        view_ = false;
+        sync();
+        return *this;
+    }
+    
+    // Point at external memory; the caller keeps it alive
+    void attach(const T* data, size_t size) {
+        owned_.clear();
+        owned_.shrink_to_fit();
+        data_ = data;
+        size_ = size;
+        view_ = true;
+    }
+    
+    bool is_view() const { return view_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const T* data() const { return data_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    const T& operator[](size_t index) const { return data_[index]; }
+    const T& back() const { return data_[size_ - 1]; }
+    
+    // Owned heap capacity; views report zero
+    size_t capacity() const { return view_ ? 0 : owned_.capacity(); }
+    
+    void reserve(size_t capacity) {
+        materialize();
+        owned_.reserve(capacity);
+        sync();
+    }
+    
+    void push_back(const T& value) {
+        materialize();
+        owned_.push_back(value);
+        sync();
+    }
+    
+    void append(const T* values, size_t count) {
+        materialize();
+        owned_.insert(owned_.end(), values, values + count);
+        sync();
+    }
+    
+    void clear() {
+        owned_.clear();
+        reset_view();
+        sync();
+    }
+    
+private:
+    void materialize() {
+        if (!view_) return;
+        owned_.assign(data_, data_ + size_);
+        view_ = false;
+        sync();
+    }
+    
+    void sync() {
+        data_ = owned_.data();
+        size_ = owned_.size();
+    }
+    
+    void reset_view() {
+        view_ = false;
+        data_ = nullptr;
+        size_ = 0;
+    }
+    
+    std::vector<T> owned_;
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+    bool view_ = false;
+};
+
+// Variable-length strings packed as one character blob plus offsets, so the
+// column can be viewed in place like any other
+class StringColumn {
+public:
+    StringColumn() { offsets_.push_back(0); }
+    
+    size_t size() const { return offsets_.size() - 1; }
+    std::string_view operator[](size_t index) const {
+        return std::string_view(chars_.data() + offsets_[index],
+                                static_cast<size_t>(offsets_[index + 1] - offsets_[index]));
+    }
+    
+    void reserve(size_t capacity) { offsets_.reserve(capacity + 1); }
+    
+    void push_back(std::string_view value) {
+        chars_.append(value.data(), value.size());
+        offsets_.push_back(static_cast<uint64_t>(chars_.size()));
+    }
+    
+    void clear() {
+        chars_.clear();
+        offsets_.clear();
+        offsets_.push_back(0);
+    }
+    
+    void attach(const uint64_t* offsets, size_t count, const char* chars, size_t char_count) {
+        offsets_.attach(offsets, count + 1);
+        chars_.attach(chars, char_count);
+    }
+    
+    void reorder(const std::vector<size_t>& indices) {
+        StringColumn sorted;
+        sorted.reserve(indices.size());
+        for (size_t idx : indices) sorted.push_back((*this)[idx]);
+        *this = std::move(sorted);
+    }
+    
+    const Column<uint64_t>& offsets() const { return offsets_; }
+    const Column<char>& chars() const { return chars_; }
+    size_t capacity_bytes() const {
+        return offsets_.capacity() * sizeof(uint64_t) + chars_.capacity();
+    }
+    
+private:
+    Column<uint64_t> offsets_;  // size() + 1 entries, offsets_[0] == 0
+    Column<char> chars_;
+};
+
 // High-performance columnar storage for tick data
 class TickDataStore {
 public:
     struct TickData {
-        std::vector<Timestamp> timestamps;
-        std::vector<Price> bid_prices;
-        std::vector<Price> ask_prices;
-        std::vector<Volume> bid_sizes;
-        std::vector<Volume> ask_sizes;
-        std::vector<Price> last_prices;
-        std::vector<Volume> volumes;
-        std::vector<double> open;
-        std::vector<double> high;
-        std::vector<double> low;
-        std::vector<double> close;
-        std::vector<std::string> date;
+        Column<Timestamp> timestamps;
+        Column<Price> bid_prices;
+        Column<Price> ask_prices;
+        Column<Volume> bid_sizes;
+        Column<Volume> ask_sizes;
+        Column<Price> last_prices;
+        Column<Volume> volumes;
+        Column<double> open;
+        Column<double> high;
+        Column<double> low;
+        Column<double> close;
+        StringColumn date;
+        // Running hash over the rows added through add_tick; rows attached
+        // as views are hashed on demand by content_hash()
+        ContentHash hash;
+        size_t hashed_rows = 0;
         
         void reserve(size_t capacity) {
             timestamps.reserve(capacity);
@@ -55,26 +225,56 @@ public:
             low.clear();
             close.clear();
             date.clear();
+            hash.reset();
+            hashed_rows = 0;
         }
         
         size_t size() const { return timestamps.size(); }
         
+        void hash_row(ContentHash& h, size_t index) const {
+            h.update_value(timestamps[index].time_since_epoch().count());
+            h.update_value(bid_prices[index]);
+            h.update_value(ask_prices[index]);
+            h.update_value(bid_sizes[index]);
+            h.update_value(ask_sizes[index]);
+            h.update_value(last_prices[index]);
+            h.update_value(volumes[index]);
+            h.update_value(open[index]);
+            h.update_value(high[index]);
+            h.update_value(low[index]);
+            h.update_value(close[index]);
+            h.update_string(date[index]);
+        }
+        
+        // Hash of every row in order; incremental unless rows bypassed add_tick
+        uint64_t row_hash() const {
+            if (hashed_rows == size()) return hash.digest();
+            ContentHash h;
+            for (size_t i = 0; i < size(); ++i) hash_row(h, i);
+            return h.digest();
+        }
+        
         MarketDataTick get_tick(size_t index) const {
-            return MarketDataTick{
-                timestamps[index],
-                "", // instrument will be set by caller
-                bid_prices[index],
-                ask_prices[index],
-                bid_sizes[index],
-                ask_sizes[index],
-                last_prices[index],
-                volumes[index],
-                open[index],
-                high[index],
-                low[index],
-                close[index],
-                date[index]
-            };
+            MarketDataTick tick;  // instrument will be set by caller
+            read_tick(index, tick);
+            return tick;
+        }
+        
+        // get_tick() into an existing tick, leaving its instrument alone; the
+        // date is assigned in place, so a reused tick does not allocate
+        void read_tick(size_t index, MarketDataTick& tick) const {
+            tick.timestamp = timestamps[index];
+            tick.bid_price = bid_prices[index];
+            tick.ask_price = ask_prices[index];
+            tick.bid_size = bid_sizes[index];
+            tick.ask_size = ask_sizes[index];
+            tick.last_price = last_prices[index];
+            tick.volume = volumes[index];
+            tick.open = open[index];
+            tick.high = high[index];
+            tick.low = low[index];
+            tick.close = close[index];
+            tick.date.assign(date[index]);
         }
         
         void add_tick(const MarketDataTick& tick) {
@@ -90,6 +290,27 @@ public:
             low.push_back(tick.low);
             close.push_back(tick.close);
             date.push_back(tick.date);
+            if (hashed_rows + 1 == size()) {
+                hash_row(hash, hashed_rows);
+                ++hashed_rows;
+            }
+        }
+        
+        // Copy rows [begin, end) of other onto the end, a column at a time
+        void append_rows(const TickData& other, size_t begin, size_t end) {
+            const size_t count = end - begin;
+            timestamps.append(other.timestamps.data() + begin, count);
+            bid_prices.append(other.bid_prices.data() + begin, count);
+            ask_prices.append(other.ask_prices.data() + begin, count);
+            bid_sizes.append(other.bid_sizes.data() + begin, count);
+            ask_sizes.append(other.ask_sizes.data() + begin, count);
+            last_prices.append(other.last_prices.data() + begin, count);
+            volumes.append(other.volumes.data() + begin, count);
+            open.append(other.open.data() + begin, count);
+            high.append(other.high.data() + begin, count);
+            low.append(other.low.data() + begin, count);
+            close.append(other.close.data() + begin, count);
+            for (size_t i = begin; i < end; ++i) date.push_back(other.date[i]);
         }
     };
     
@@ -108,6 +329,16 @@ public:
         }
     }
     
+    // Mutable column access for loaders that fill or attach columns directly
+    TickData& get_or_create(const InstrumentId& instrument) {
+        return data_[instrument];
+    }
+    
+    // Keep the memory behind attached column views alive as long as the store
+    void retain_backing(std::shared_ptr<const void> backing) {
+        backings_.push_back(std::move(backing));
+    }
+    
     // Get all ticks for instrument
     const TickData* get_ticks(const InstrumentId& instrument) const {
         auto it = data_.find(instrument);
@@ -137,6 +368,24 @@ public:
         return result;
     }
     
+    // Copy of the rows with timestamps in [start_time, end_time]; instruments
+    // without any keep an empty entry
+    TickDataStore slice(Timestamp start_time, Timestamp end_time) const {
+        TickDataStore result;
+        for (const auto& [instrument, ticks] : data_) {
+            auto& dest = result.data_[instrument];
+            auto inside = [&](size_t i) { return ticks.timestamps[i] >= start_time && ticks.timestamps[i] <= end_time; };
+            for (size_t i = 0; i < ticks.size();) {
+                if (!inside(i)) { ++i; continue; }
+                size_t end = i + 1;
+                while (end < ticks.size() && inside(end)) ++end;
+                dest.append_rows(ticks, i, end);
+                i = end;
+            }
+        }
+        return result;
+    }
+    
     // Get tick at specific index
     std::optional<MarketDataTick> get_tick_at(const InstrumentId& instrument, size_t index) const {
         auto it = data_.find(instrument);
@@ -170,6 +419,7 @@ public:
     // Clear all data
     void clear() {
         data_.clear();
+        backings_.clear();
     }
     
     // Clear data for specific instrument
@@ -182,22 +432,38 @@ public:
     
     // Sort ticks by timestamp for each instrument
     void sort_by_timestamp() {
+        TraceSpan span("sort");
         for (auto& [instrument, ticks] : data_) {
             // Create index vector for sorting
             std::vector<size_t> indices(ticks.size());
             std::iota(indices.begin(), indices.end(), 0);
             
-            // Sort indices by timestamp
-            std::sort(indices.begin(), indices.end(), 
-                     [&ticks](size_t a, size_t b) {
-                         return ticks.timestamps[a] < ticks.timestamps[b];
-                     });
+            // Sort indices by timestamp; rows sharing one keep their file order
+            std::stable_sort(indices.begin(), indices.end(),
+                             [&ticks](size_t a, size_t b) {
+                                 return ticks.timestamps[a] < ticks.timestamps[b];
+                             });
             
             // Reorder all vectors
             reorder_vectors(ticks, indices);
         }
     }
     
+    // Digest of every instrument's rows, independent of map order; cheap for
+    // stores filled through add_tick, one pass over attached views otherwise
+    uint64_t content_hash() const {
+        std::vector<std::pair<InstrumentId, uint64_t>> parts;
+        parts.reserve(data_.size());
+        for (const auto& [instrument, ticks] : data_) parts.emplace_back(instrument, ticks.row_hash());
+        std::sort(parts.begin(), parts.end());
+        ContentHash h;
+        for (const auto& [instrument, digest] : parts) {
+            h.update_string(instrument);
+            h.update_value(digest);
+        }
+        return h.digest();
+    }
+    
     // Get memory usage in bytes
     size_t memory_usage() const {
         size_t total = 0;
@@ -213,7 +479,7 @@ public:
             total += sizeof(double) * ticks.high.capacity();
             total += sizeof(double) * ticks.low.capacity();
             total += sizeof(double) * ticks.close.capacity();
-            total += sizeof(std::string) * ticks.date.capacity();
+            total += ticks.date.capacity_bytes();
         }
         return total;
     }
@@ -277,7 +543,7 @@ private:
             temp.reserve(vec.size());
             
             for (size_t idx : indices) {
-                temp.push_back(std::move(vec[idx]));
+                temp.push_back(vec[idx]);
             }
             
             vec = std::move(temp);
@@ -294,10 +560,13 @@ private:
         reorder(ticks.high);
         reorder(ticks.low);
         reorder(ticks.close);
-        reorder(ticks.date);
+        ticks.date.reorder(indices);
+        ticks.hash.reset();
+        ticks.hashed_rows = 0;
     }
     
     std::unordered_map<InstrumentId, TickData> data_;
+    std::vector<std::shared_ptr<const void>> backings_;
 };
 
 } // namespace backtest
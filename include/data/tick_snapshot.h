@@ -0,0 +1,73 @@
+#pragma once
+
+#include "data/tick_data_store.h"
+#include "utils/memory_placement.h"
+#include <cstdint>
+#include <string>
+
+namespace backtest {
+
+// Flat, position-independent image of a TickDataStore. Column arrays are
+// 64-byte aligned so a mapped image can back Column views without copying.
+//
+//   Header | InstrumentEntry[instrument_count] | names | column arrays...
+namespace TickSnapshot {
+
+constexpr char kMagic[8] = {'N', 'E', 'M', 'O', 'S', 'N', 'A', 'P'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kAlignment = 64;
+
+enum ColumnIndex : uint32_t {
+    TIMESTAMPS = 0,
+    BID_PRICES,
+    ASK_PRICES,
+    BID_SIZES,
+    ASK_SIZES,
+    LAST_PRICES,
+    VOLUMES,
+    OPEN,
+    HIGH,
+    LOW,
+    CLOSE,
+    DATE_OFFSETS,
+    DATE_CHARS,
+    COLUMN_COUNT
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t instrument_count;
+    uint64_t total_bytes;
+};
+
+struct InstrumentEntry {
+    uint64_t name_offset;
+    uint32_t name_length;
+    uint32_t reserved;
+    uint64_t rows;
+    uint64_t date_chars;
+    uint64_t column_offsets[COLUMN_COUNT];
+};
+
+// Bytes needed to encode store
+size_t encoded_size(const TickDataStore& store);
+
+// Encode store into dest, which must hold encoded_size(store) bytes
+void encode(const TickDataStore& store, char* dest, size_t size);
+
+// Point store's columns at an encoded image. The image must outlive the
+// views; callers hand its owner to store.retain_backing().
+void attach(const char* image, size_t size, TickDataStore& store);
+
+// Snapshot files
+void write_file(const TickDataStore& store, const std::string& path);
+void map_file(const std::string& path, TickDataStore& store);
+
+// Re-home store as one image in memory laid out per placement (huge pages,
+// NUMA interleave or a node-local replica); its columns become views of it
+void place(TickDataStore& store, const MemoryPlacement& placement);
+
+} // namespace TickSnapshot
+
+} // namespace backtest
@@ -1,6 +1,7 @@
 #ifndef DATA_LOADER_H
 #define DATA_LOADER_H
 
+#include "utils/types.h"
 #include <vector>
 #include <string>
 #include <map>
@@ -15,4 +16,12 @@ public:
     std::vector<DataPoint> load_data(const std::string& file_path);
 };
 
+namespace backtest {
+
+// One row of the bar CSV format: date,open,high,low,close,volume,oi. Dates
+// carry their UTC offset; throws std::runtime_error naming source otherwise.
+MarketDataTick parse_bar_row(const std::string& line, const InstrumentId& instrument, const std::string& source);
+
+} // namespace backtest
+
 #endif
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "distributed/socket_endpoint.h"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace backtest {
+
+// One scrape worth of metrics, rendered as Prometheus text exposition format
+// or as JSON. Samples that share a name form one family; add them one after
+// another with the same help text and labels that tell them apart.
+class MetricsPage {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    void gauge(const std::string& name, const std::string& help, double value, Labels labels = {});
+    void counter(const std::string& name, const std::string& help, double value, Labels labels = {});
+
+    std::string prometheus() const;
+    std::string json() const;
+
+private:
+    struct Sample {
+        Labels labels;
+        double value = 0.0;
+    };
+    struct Family {
+        std::string name;
+        std::string help;
+        const char* type;
+        std::vector<Sample> samples;
+    };
+
+    void add(const char* type, const std::string& name, const std::string& help, double value, Labels labels);
+
+    std::vector<Family> families_;
+};
+
+// HTTP/1.0 on a unix: or tcp: endpoint, served from a thread of its own:
+// GET /metrics answers in Prometheus text format, GET /metrics.json in JSON.
+// Requests are answered one at a time and each connection is closed after
+// its response. The collector fills the page on the server thread for every
+// request, so it should only read lock-free snapshots (SeqLock) of the
+// threads doing the work, never wait on them.
+class MetricsServer {
+public:
+    using Collector = std::function<void(MetricsPage&)>;
+
+    MetricsServer(const std::string& endpoint, Collector collect);
+    ~MetricsServer();
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+private:
+    void serve();
+    void respond(int fd);
+
+    Endpoint endpoint_;
+    Collector collect_;
+    int listen_fd_ = -1;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace backtest
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+namespace backtest {
+
+// Stream socket address written as "unix:/path/to/socket" or "tcp:host:port".
+// Shared by the sweep coordinator, its workers and the metrics server.
+// POSIX only; on Windows every call throws.
+struct Endpoint {
+    bool is_unix = true;
+    std::string path;  // unix socket path
+    std::string host;
+    std::string port;
+
+    static Endpoint parse(const std::string& text);
+};
+
+// Listening socket; a stale unix socket file is replaced
+int listen_on(const Endpoint& endpoint);
+
+// Connected socket, or -1 if nothing is listening yet
+int try_connect(const Endpoint& endpoint);
+
+// Closes a listening socket and removes its unix socket file
+void close_listener(int fd, const Endpoint& endpoint);
+
+} // namespace backtest
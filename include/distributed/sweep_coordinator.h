@@ -0,0 +1,133 @@
+#pragma once
+
+#include "utils/config.h"
+#include "utils/seqlock.h"
+#include "data/tick_data_store.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace backtest {
+
+// Compact per-run result streamed from a worker back to the coordinator
+struct SweepResult {
+    uint64_t run_index = 0;
+    double total_pnl = 0.0;
+    uint64_t total_trades = 0;
+    double elapsed_ms = 0.0;
+    uint32_t status = 0;      // 0 = ok, 1 = run failed
+    uint32_t worker_pid = 0;
+    uint64_t ticks = 0;       // Ticks replayed; split evenly like elapsed_ms for shared replays
+};
+
+class MetricsPage;
+
+// Live state of a sweep for the metrics server. Fixed size so it can be
+// published through a SeqLock: workers past kMaxWorkers are not itemised and
+// only the kBestRuns most profitable runs are kept.
+struct SweepProgress {
+    static constexpr size_t kMaxWorkers = 64;
+    static constexpr size_t kBestRuns = 5;
+
+    struct Worker {
+        uint32_t pid = 0;
+        uint32_t busy = 0;       // Holding a task right now
+        uint64_t tasks = 0;
+        uint64_t ticks = 0;
+        double busy_ms = 0.0;    // Sum of the tasks' elapsed_ms
+        uint64_t rss_bytes = 0;  // Local workers only
+    };
+
+    uint64_t total_runs = 0;
+    uint64_t completed_runs = 0;
+    uint64_t failed_runs = 0;
+    uint64_t pending_tasks = 0;
+    uint64_t requeued_tasks = 0;
+    uint64_t connected_workers = 0;
+    double elapsed_seconds = 0.0;
+    uint64_t data_bytes = 0;  // Market data image the runs read
+    uint64_t rss_bytes = 0;   // Process holding the queue
+    uint64_t worker_count = 0;
+    std::array<Worker, kMaxWorkers> workers{};
+    uint64_t best_count = 0;
+    std::array<SweepResult, kBestRuns> best{};  // By total_pnl, best first
+
+    // Count a finished run against its worker and the best runs
+    void record(const SweepResult& result);
+    // Entry for pid, added if new; nullptr once kMaxWorkers are listed
+    Worker* worker(uint32_t pid);
+};
+static_assert(std::is_trivially_copyable_v<SweepProgress>, "SweepProgress is published through SeqLock");
+
+// Throughput, queue depth, memory and best runs of a sweep as nemo_sweep_*
+// and nemo_worker_* metrics
+void add_sweep_metrics(MetricsPage& page, const SweepProgress& progress);
+
+// Endpoints are "unix:/path/to/socket" or "tcp:127.0.0.1:5555"
+struct SweepCoordinatorOptions {
+    std::string endpoint;
+    std::string plan_path;
+    std::string snapshot_path;      // market data image written before dispatch
+    std::string results_path;       // CSV of all results, empty to skip
+    std::string worker_executable;  // nemo binary used for local workers
+    size_t local_workers = 0;       // worker processes to spawn on this host
+    size_t max_respawns = 0;        // replacements for local workers that die
+    std::vector<std::string> worker_args;  // extra arguments for local workers
+};
+
+// Partitions a compiled RunPlan into one task per run and hands them to
+// worker processes that pull over a socket. Tasks held by a worker that
+// disconnects are put back at the front of the queue. With data.numa =
+// "replicate", local workers are spread round-robin over the NUMA nodes.
+class SweepCoordinator {
+public:
+    explicit SweepCoordinator(SweepCoordinatorOptions options);
+
+    // Blocks until every run has a result; results are ordered by run index
+    std::vector<SweepResult> run();
+
+    size_t requeued_tasks() const { return requeued_tasks_; }
+
+    // Published by run() every 100 ms; safe to read from any thread
+    const SeqLock<SweepProgress>& progress() const { return progress_; }
+
+private:
+    SweepCoordinatorOptions options_;
+    size_t requeued_tasks_ = 0;
+    SeqLock<SweepProgress> progress_;
+};
+
+struct SweepWorkerOptions {
+    std::string endpoint;
+    size_t crash_after = 0;  // Failure injection: exit without replying after N tasks
+    int numa_node = -1;      // Pin to this node and keep the data replica there; -1 leaves scheduling alone
+};
+
+// Worker loop: connect, pull tasks until the coordinator says stop
+int run_sweep_worker(const SweepWorkerOptions& options);
+
+// CSV with one row per result: run, swept values, P&L, trades, timing, status
+void write_sweep_results(const RunPlan& plan, const std::vector<SweepResult>& results, const std::string& path);
+
+// Run one plan entry on data already loaded into store
+SweepResult run_plan_entry(const RunPlan& plan, size_t run, const TickDataStore& store);
+
+// Run plan entries that share everything but mid-run changeable parameters
+// (StrategyBase::set_parameter) from one replay: the first run of each group
+// goes through, checkpointing every checkpoint_ticks ticks, and every other
+// run forks from the last checkpoint at which it still agreed with it.
+std::vector<SweepResult> run_plan_forked(const RunPlan& plan, const std::vector<size_t>& runs,
+                                         const TickDataStore& store, size_t checkpoint_ticks = 256);
+
+// True when runs differ only in simple_sma_broad parameters or initial capital,
+// so they can share one replay through SimpleSMABroadBatchStrategy
+bool plan_is_batchable(const RunPlan& plan);
+
+// Run several plan entries in lock-step, one batch lane per run (at most
+// SimpleSMABroadBatchStrategy::kMaxLanes). elapsed_ms is the batch time split evenly.
+std::vector<SweepResult> run_plan_batch(const RunPlan& plan, const std::vector<size_t>& runs,
+                                        const TickDataStore& store);
+
+} // namespace backtest
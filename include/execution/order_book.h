@@ -1,6 +1,7 @@
 #pragma once
 
 #include "utils/types.h"
+#include "utils/trace.h"
 #include <map>
 #include <queue>
 #include <memory>
@@ -79,6 +80,7 @@ public:
     
     // Execute market order and return fills
     std::vector<Fill> execute_market_order(const Order& order, Timestamp timestamp) {
+        TraceSpan span("match");
         std::vector<Fill> fills;
         Volume remaining = order.quantity;
         
@@ -128,6 +130,7 @@ public:
     
     // Check if limit order can be filled immediately
     std::vector<Fill> execute_limit_order(const Order& order, Timestamp timestamp) {
+        TraceSpan span("match");
         std::vector<Fill> fills;
         Volume remaining = order.quantity;
         
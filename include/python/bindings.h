@@ -3,16 +3,63 @@
 #include "core/engine.h"
 #include "strategy/strategy_base.h"
 #include "utils/types.h"
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+// Fixed C ABI shared with compiled Python callbacks (numba.cfunc, ctypes).
+// Field order and sizes must match strategies/python/native_abi.py; only append
+// new fields at the end and bump NEMO_NATIVE_ABI_VERSION when doing so.
+#define NEMO_NATIVE_ABI_VERSION 1
+
+extern "C" {
+
+struct NemoNativeTick {
+    int64_t timestamp_ns;
+    double bid_price;
+    double ask_price;
+    double last_price;
+    double open;
+    double high;
+    double low;
+    double close;
+    uint64_t volume;
+    uint32_t instrument_index;  // Engine-assigned per-strategy slot, stable for the run
+    uint32_t reserved;
+};
+
+struct NemoNativeState {
+    double position;            // Current position for this instrument
+    double average_price;
+    uint64_t tick_count;        // Ticks delivered for this instrument so far
+    double* user_state;         // Callback-owned scratch space, zeroed at start
+    uint32_t user_state_len;
+    uint32_t reserved;
+};
+
+// Return value is a NativeAction code
+typedef int32_t (*NemoTickCallback)(const NemoNativeTick* tick, NemoNativeState* state);
+
+}
 
 namespace backtest {
 namespace python {
 
+// Actions a native callback can request after each tick
+enum class NativeAction : int32_t {
+    HOLD = 0,
+    BUY = 1,
+    SELL = 2,
+    CLOSE = 3
+};
+
 // Python strategy wrapper
 class PythonStrategy : public StrategyBase {
 public:
     explicit PythonStrategy(const StrategyId& strategy_id, const std::string& python_module);
+    ~PythonStrategy() override;
     
     void initialize() override;
     void on_market_data(const MarketEvent& event) override;
@@ -20,10 +67,30 @@ public:
     void on_risk_event(const RiskEvent& event) override;
     void on_timer(const TimerEvent& event) override;
     
+    // Route ticks to a compiled C callback instead of the interpreter.
+    // state_slots doubles of scratch space are reserved per instrument.
+    // BUY and SELL fill one unit at the current price, CLOSE flattens.
+    void set_native_callback(NemoTickCallback callback, size_t state_slots = 0);
+    void clear_native_callback();
+    bool has_native_callback() const { return native_callback_ != nullptr; }
+    
 private:
+    struct NativeInstrumentState {
+        NemoNativeState state{};
+        std::vector<double> user_state;
+    };
+    
     std::string python_module_;
     void* python_strategy_instance_ = nullptr;  // PyObject* in implementation
     
+    // Native fast path
+    NemoTickCallback native_callback_ = nullptr;
+    size_t native_state_slots_ = 0;
+    std::vector<NativeInstrumentState> native_states_;  // by slot
+    
+    void dispatch_native(const MarketDataTick& tick);
+    // Fills at the engine's current price and books the realized P&L
+    void trade(const InstrumentId& instrument, Side side, Volume quantity);
     void call_python_method(const std::string& method_name, const std::vector<std::string>& args = {});
 };
 
@@ -31,8 +98,17 @@ private:
 namespace api {
     
     // Engine control
+    // Starts a fresh engine (configured from config_file when given); strategies
+    // added before are dropped
     void initialize_engine(const std::string& config_file = "");
+    // The engine owns the strategy; attach_native_callback and the getters find it by id
     void add_strategy_from_python(const std::string& strategy_id, const std::string& module_name);
+    
+    // Attach a compiled callback (numba cfunc .address or ctypes pointer value)
+    void attach_native_callback(const std::string& strategy_id, uintptr_t callback_address,
+                                size_t state_slots = 0);
+    void detach_native_callback(const std::string& strategy_id);
+    int native_abi_version();
     void load_data_file(const std::string& filepath);
     void run_backtest();
     void run_backtest_range(const std::string& start_date, const std::string& end_date);
@@ -108,6 +184,18 @@ void cleanup_python_bindings();
               "Run backtest for specific date range", \
               pybind11::arg("start_date"), pybind11::arg("end_date")); \
         \
+        m.def("attach_native", &backtest::python::api::attach_native_callback, \
+              "Run a strategy through a compiled C callback", \
+              pybind11::arg("strategy_id"), pybind11::arg("callback_address"), \
+              pybind11::arg("state_slots") = 0); \
+        \
+        m.def("detach_native", &backtest::python::api::detach_native_callback, \
+              "Fall back to Python method calls for a strategy", \
+              pybind11::arg("strategy_id")); \
+        \
+        m.def("native_abi_version", &backtest::python::api::native_abi_version, \
+              "Version of the native callback ABI"); \
+        \
         /* Data access */ \
         m.def("get_prices", &backtest::python::api::get_prices, \
               "Get price series for instrument", \
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "strategy/coroutine_strategy.h"
+
+namespace backtest {
+
+// Long-only channel breakout, written as a coroutine per instrument: buy a
+// close above the highest high of the last `lookback` bars, sell a close
+// below their lowest low, then stand aside for `cooldown`.
+class ChannelBreakoutStrategy : public CoroutineStrategy {
+public:
+    ChannelBreakoutStrategy(const StrategyId& strategy_id, size_t lookback, Duration cooldown, Volume quantity)
+        : CoroutineStrategy(strategy_id), lookback_(lookback), cooldown_(cooldown), quantity_(quantity) {}
+
+protected:
+    Task run(size_t slot) override;
+
+private:
+    size_t lookback_;
+    Duration cooldown_;
+    Volume quantity_;
+};
+
+} // namespace backtest
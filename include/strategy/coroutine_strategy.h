@@ -0,0 +1,122 @@
+#pragma once
+
+#include "strategy/strategy_base.h"
+#include "utils/frame_pool.h"
+#include <coroutine>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace backtest {
+
+// Strategy written as one coroutine per instrument slot instead of a state
+// machine in on_market_data:
+//
+//     Task run(size_t slot) override {
+//         for (;;) {
+//             const MarketDataTick& bar = co_await next_bar();
+//             if (!entry_signal()) continue;
+//             Fill entry = co_await fill(Side::BUY, bar.close);
+//             co_await timer(std::chrono::minutes(30));
+//             co_await fill(Side::SELL, this->bar().close, entry.quantity);
+//         }
+//     }
+//
+// The engine's replay loop is the scheduler: each routed tick of a slot
+// resumes that slot's coroutine if it is due, on the replay thread, and the
+// coroutine runs until its next co_await. Frames come from FramePool. The
+// body must be a single coroutine; awaiting another Task is not supported.
+class CoroutineStrategy : public StrategyBase {
+public:
+    class Task {
+    public:
+        struct promise_type {
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            // Propagates out of the resume, i.e. out of the engine's dispatch
+            void unhandled_exception() { throw; }
+            static void* operator new(size_t size) { return FramePool::allocate(size); }
+            static void operator delete(void* frame, size_t size) { FramePool::deallocate(frame, size); }
+        };
+
+        Task() = default;
+        Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                reset();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        ~Task() { reset(); }
+
+        bool done() const { return !handle_ || handle_.done(); }
+        void resume() const { handle_.resume(); }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+        void reset() {
+            if (handle_) handle_.destroy();
+            handle_ = {};
+        }
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    explicit CoroutineStrategy(const StrategyId& strategy_id) : StrategyBase(strategy_id) {}
+
+    // Starts run() for every slot and lets it reach its first co_await
+    void initialize() override;
+    void on_market_data(const MarketEvent& event) final;
+
+protected:
+    // Body for one slot; history() and current_slot() refer to that slot
+    virtual Task run(size_t slot) = 0;
+
+    // Resumes on the slot's next tick, the bar of the new tick
+    struct BarAwaiter {
+        CoroutineStrategy* strategy;
+        int64_t wake_ns;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) const noexcept {
+            strategy->lanes_[strategy->current_slot()].wake_ns = wake_ns;
+        }
+        const MarketDataTick& await_resume() const noexcept { return *strategy->bar_; }
+    };
+    // Orders fill when placed in this engine, so this never suspends
+    struct FillAwaiter {
+        CoroutineStrategy* strategy;
+        Side side;
+        Price price;
+        Volume quantity;
+        bool await_ready() const noexcept { return true; }
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+        Fill await_resume() const { return strategy->place(side, price, quantity); }
+    };
+
+    BarAwaiter next_bar() { return BarAwaiter{this, std::numeric_limits<int64_t>::min()}; }
+    // Resumes on the slot's first tick at or after the current bar's time plus delay
+    BarAwaiter timer(Duration delay);
+    FillAwaiter fill(Side side, Price price, Volume quantity = 1) { return FillAwaiter{this, side, price, quantity}; }
+
+    // Bar being delivered; only valid while the coroutine runs on a tick,
+    // and a reference to it only until the next co_await
+    const MarketDataTick& bar() const { return *bar_; }
+
+private:
+    struct Lane {
+        Task task;
+        int64_t wake_ns = std::numeric_limits<int64_t>::min();
+    };
+
+    Fill place(Side side, Price price, Volume quantity);
+
+    std::vector<Lane> lanes_;  // by slot
+    const MarketDataTick* bar_ = nullptr;
+};
+
+} // namespace backtest
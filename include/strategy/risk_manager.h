@@ -72,6 +72,17 @@ public:
     explicit RiskManager(const RiskLimits& limits = RiskLimits{})
         : limits_(limits) {}
     
+    // Snapshot of another manager's limits, positions and counters (engine forks)
+    RiskManager(const RiskManager& other) {
+        std::lock_guard<std::mutex> lock(other.mutex_);
+        limits_ = other.limits_;
+        strategy_limits_ = other.strategy_limits_;
+        positions_ = other.positions_;
+        exposures_ = other.exposures_;
+        rate_limiting_ = other.rate_limiting_;
+        strategy_pnl_ = other.strategy_pnl_;
+    }
+    
     // Set risk limits
     void set_limits(const RiskLimits& limits) {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -2,9 +2,12 @@
 
 #include "strategy_base.h"
 #include "utils/config.h"
+#include "utils/rolling_window.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <cmath>
+#include <algorithm>
 
 namespace backtest {
 
@@ -15,30 +18,60 @@ public:
                            int atr_period, int adx_period, double adx_threshold,
                            double risk_per_trade, double initial_capital, double slippage,
                            double max_daily_drawdown);
+    std::unique_ptr<StrategyBase> clone() const override { return std::make_unique<SimpleSMABroadStrategy>(*this); }
+    // Entry thresholds, sizing, slippage and the drawdown guard can change mid-run
+    bool set_parameter(const std::string& name, double value) override;
+    bool parameter_agrees(const std::string& name, double value) const override;
+    // Indicators read the store and rolling windows only up to the current bar
+    bool is_causal() const override { return true; }
+    size_t history_rows() const override { return std::max<size_t>(close_window_, 20); }
+    void save_state(BinaryWriter& out) const override;
+    void load_state(BinaryReader& in) override;
     void initialize() override;
+    void on_stop() override;
     void on_market_data(const MarketEvent& event) override;
+    void on_warmup_data(const MarketEvent& event) override;
+    void on_timer(const TimerEvent& event) override;
     void on_fill(const FillEvent& event) override;
+    
+    // Empty path disables the trade log
+    void set_log_path(const std::string& path) { log_path = path; }
+    double get_equity() const { return equity; }
 private:
     // Configurable parameters
     int short_ema, long_ema, rsi_period, atr_period, adx_period;
     double rsi_lb, rsi_ub, adx_threshold, risk_per_trade, initial_capital, slippage, max_daily_drawdown;
     // State
     double equity, daily_peak;
+    bool sessions_driven_ = false;  // Daily drawdown guard active once the engine sends session timers
     int position;
     double entry_price, stop_level, tp_level, original_stop_distance;
     std::string log_path;
     std::vector<std::string> trade_logs;
     std::string last_date;
-    // Indicator state
-    std::vector<double> close, high, low, volume;
-    std::vector<std::string> datetime;
-    // Member variables for indicator history
-    std::vector<double> tr_hist_m;
-    std::vector<double> plus_dm_hist_m;
-    std::vector<double> minus_dm_hist_m;
-    std::vector<double> dx_hist_m;
+    // Derived indicator series; prices and volumes are read from the data store via history()
+    RollingWindow<double> tr_hist_m;
+    RollingWindow<double> plus_dm_hist_m;
+    RollingWindow<double> minus_dm_hist_m;
+    RollingWindow<double> dx_hist_m;
+    size_t close_window_;  // Closes needed by the longest indicator
     int print_count_m; // For debugging tick printing
 
+    // Thresholds t that keep every `x > t` comparison made so far unchanged: lo <= t < hi
+    struct ThresholdRange {
+        double lo = -HUGE_VAL, hi = HUGE_VAL;
+        void observe(double x, double t) {
+            if (std::isnan(x)) return;  // Comparison is false for every t
+            if (x > t) hi = std::min(hi, x);
+            else lo = std::max(lo, x);
+        }
+        bool contains(double t) const { return lo <= t && t < hi; }
+    };
+    ThresholdRange rsi_lb_range_, rsi_ub_range_, adx_range_;  // rsi_ub_range_ holds -rsi_ub
+    bool sized_trade_ = false;       // risk_per_trade and slippage have been used
+    bool checked_drawdown_ = false;  // max_daily_drawdown has been used
+
+    int begin_bar(const MarketDataTick& tick); // Returns the bar's row in the data store
     void log_trade(const std::string& log_line);
     void flush_logs();
 };
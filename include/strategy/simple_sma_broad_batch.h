@@ -0,0 +1,67 @@
+#pragma once
+
+#include "strategy_base.h"
+#include "utils/config.h"
+#include "utils/rolling_window.h"
+#include <vector>
+
+namespace backtest {
+
+// SimpleSMABroadStrategy evaluated for many parameter sets in one pass over
+// the data. Lane state is kept structure-of-arrays; every indicator is a loop
+// over lanes with the per-lane window expressed as a mask, and entries and
+// exits are per-lane masks applied with selects. Per-lane results match the
+// scalar strategy run by run (tests/batch_parity_test.cpp). Trade logs and
+// tick printing are not produced.
+class SimpleSMABroadBatchStrategy : public StrategyBase {
+public:
+    static constexpr size_t kMaxLanes = 16;
+
+    explicit SimpleSMABroadBatchStrategy(const StrategyId& id);
+
+    // One lane per run; parameters are read like StrategyFactory::create_from_config
+    size_t add_lane(const Config& config);
+    size_t lane_count() const { return short_ema_.size(); }
+
+    std::unique_ptr<StrategyBase> clone() const override {
+        return std::make_unique<SimpleSMABroadBatchStrategy>(*this);
+    }
+    void initialize() override;
+    void on_market_data(const MarketEvent& event) override;
+    void on_warmup_data(const MarketEvent& event) override;
+    void on_timer(const TimerEvent& event) override;
+
+    double lane_pnl(size_t lane) const { return realized_[lane]; }
+    size_t lane_trades(size_t lane) const { return trades_[lane]; }
+    double lane_equity(size_t lane) const { return equity_[lane]; }
+
+private:
+    int begin_bar();
+    void push_dx_row(const std::vector<double>& dx);
+    void dx_ema(std::vector<double>& out) const;
+
+    // Lane parameters
+    std::vector<int> short_ema_, long_ema_, rsi_period_, atr_period_, adx_period_;
+    std::vector<double> rsi_lb_, rsi_ub_, adx_threshold_, risk_per_trade_, initial_capital_;
+    std::vector<double> slippage_, max_daily_drawdown_;
+    // EMA smoothing factors, precomputed per lane and period
+    std::vector<double> k_short_, k_long_, k_atr_, k_adx_;
+    // Lane state
+    std::vector<double> equity_, daily_peak_, realized_;
+    std::vector<double> entry_price_, stop_level_, tp_level_, original_stop_distance_;
+    std::vector<int> position_;
+    std::vector<size_t> trades_;
+    bool sessions_driven_ = false;
+    // Scratch, one value per lane
+    std::vector<double> ema_short_, ema_long_, gain_, loss_, rsi_, atr_, tr_ema_, plus_ema_, minus_ema_, dx_, adx_, net_pnl_;
+    std::vector<int> heavy_loss_, stop_hit_, target_hit_;  // Exit masks
+    // Derived series; TR and directional movement do not depend on lane parameters
+    RollingWindow<double> tr_hist_;
+    RollingWindow<double> plus_dm_hist_;
+    RollingWindow<double> minus_dm_hist_;
+    std::vector<double> dx_rows_;  // Per-lane DX, one row of lane_count() values per bar
+    size_t dx_capacity_ = 1;       // Rows kept visible
+    size_t close_window_ = 2;
+};
+
+} // namespace backtest
@@ -1,13 +1,28 @@
 #pragma once
 
 #include "core/events.h"
+#include "data/intrabar_source.h"
+#include "data/session_filter.h"
+#include "data/tick_data_store.h"
 #include "utils/types.h"
+#include "utils/binary_io.h"
 #include "utils/logging.h"
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <span>
+#include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
 namespace backtest {
 
+struct Config;
+class TimerQueue;
+
+// Price columns readable through StrategyBase::history()
+enum class Field { Open, High, Low, Close, Last, Bid, Ask };
+
 // Base class for all trading strategies
 class StrategyBase {
 public:
@@ -28,9 +43,118 @@ public:
     virtual void on_fill(const FillEvent& event) {}
     virtual void on_risk_event(const RiskEvent& event) {}
     virtual void on_timer(const TimerEvent& event) {}
+    // Out-of-session ticks requested through SessionSpec::warmup_ticks; feed history, don't trade
+    virtual void on_warmup_data(const MarketEvent& event) {}
     
     // Strategy identification
     const StrategyId& id() const { return strategy_id_; }
+    // Bump whenever a code change alters results; part of the result cache key
+    virtual std::string version() const { return "1"; }
+    
+    // Forking (BacktestEngine::fork): full copy of the strategy mid-run, or
+    // nullptr when the strategy cannot be copied
+    virtual std::unique_ptr<StrategyBase> clone() const { return nullptr; }
+    // Change a parameter mid-run; false if it cannot change after start
+    virtual bool set_parameter(const std::string&, double) { return false; }
+    // True if a run using value for name would have made every decision so far the same way
+    virtual bool parameter_agrees(const std::string&, double) const { return false; }
+    
+    // Checkpoints (BacktestEngine::save_checkpoint): a causal strategy decides
+    // only from ticks already delivered and reads at most history_rows() rows
+    // back, so its saved state continues exactly on rows appended later.
+    // load_state() replaces initialize() on a resumed run.
+    virtual bool is_causal() const { return false; }
+    virtual size_t history_rows() const { return 0; }
+    virtual void save_state(BinaryWriter&) const {
+        throw std::logic_error("Strategy " + strategy_id_ + " cannot be checkpointed");
+    }
+    virtual void load_state(BinaryReader&) {
+        throw std::logic_error("Strategy " + strategy_id_ + " cannot be checkpointed");
+    }
+    // P&L, trade count and positions kept by the base class
+    void save_base_state(BinaryWriter& out) const;
+    void load_base_state(BinaryReader& in);
+    
+    // Instrument subscriptions; a strategy with none receives every instrument
+    void subscribe(const InstrumentId& instrument) {
+        if (!is_subscribed(instrument)) subscriptions_.push_back(instrument);
+    }
+    const std::vector<InstrumentId>& subscriptions() const { return subscriptions_; }
+    bool is_subscribed(const InstrumentId& instrument) const {
+        return std::find(subscriptions_.begin(), subscriptions_.end(), instrument) != subscriptions_.end();
+    }
+    bool receives(const InstrumentId& instrument) const {
+        return subscriptions_.empty() || is_subscribed(instrument);
+    }
+    
+    // Dense per-strategy instrument slots, assigned by the engine when it builds
+    // its routing table. Per-instrument state lives in vectors indexed by slot.
+    size_t assign_slot(const InstrumentId& instrument) {
+        auto [it, inserted] = slot_index_.try_emplace(instrument, slot_instruments_.size());
+        if (inserted) slot_instruments_.push_back(instrument);
+        return it->second;
+    }
+    void clear_slots() {
+        slot_index_.clear();
+        slot_instruments_.clear();
+        slot_ticks_.clear();
+        slot_cursors_.clear();
+        slot_intrabar_.clear();
+        slot_timer_lanes_.clear();
+    }
+    // Store columns behind a slot; history() reads them up to the delivery cursor
+    void bind_slot_data(size_t slot, const TickDataStore::TickData* ticks) {
+        if (slot >= slot_ticks_.size()) {
+            slot_ticks_.resize(slot + 1, nullptr);
+            slot_cursors_.resize(slot + 1, 0);
+        }
+        slot_ticks_[slot] = ticks;
+        slot_cursors_[slot] = 0;
+    }
+    // Finer data of a slot's instrument, consulted by first_touch(); null when none
+    void bind_slot_intrabar(size_t slot, std::shared_ptr<const IntrabarSource> source) {
+        if (slot >= slot_intrabar_.size()) slot_intrabar_.resize(slot + 1);
+        slot_intrabar_[slot] = std::move(source);
+    }
+    // Engine timer queue and the queue lane of a slot's instrument (TimerQueue::kNoLane without data)
+    void set_timer_queue(TimerQueue* timers) { timer_queue_ = timers; }
+    void bind_slot_timers(size_t slot, size_t lane) {
+        if (slot >= slot_timer_lanes_.size()) slot_timer_lanes_.resize(slot + 1, std::numeric_limits<size_t>::max());
+        slot_timer_lanes_[slot] = lane;
+    }
+    size_t slot_count() const { return slot_instruments_.size(); }
+    const InstrumentId& slot_instrument(size_t slot) const { return slot_instruments_[slot]; }
+    
+    // Routed delivery: on_market_data sees slot as current_slot() and history()
+    // ends at tick_index, the store row of the event. live_index is the row at
+    // the engine's current time, later than tick_index under market data latency.
+    void dispatch_market_data(const MarketEvent& event, size_t slot, size_t tick_index) {
+        dispatch_market_data(event, slot, tick_index, tick_index);
+    }
+    void dispatch_market_data(const MarketEvent& event, size_t slot, size_t tick_index, size_t live_index) {
+        advance_cursor(slot, tick_index);
+        live_row_ = live_index;
+        on_market_data(event);
+    }
+    void dispatch_warmup_data(const MarketEvent& event, size_t slot, size_t tick_index) {
+        advance_cursor(slot, tick_index);
+        on_warmup_data(event);
+    }
+    void dispatch_timer(const TimerEvent& event, size_t slot) {
+        current_slot_ = slot;
+        on_timer(event);
+    }
+    
+    // Active sessions; the engine only delivers in-session ticks (plus warm-up)
+    void set_session(const SessionSpec& session) { session_ = session; }
+    const SessionSpec& session() const { return session_; }
+    
+    // Conflated delivery: at most one on_market_data per slot per interval,
+    // carrying every row since the last one (first open, high/low, summed
+    // volume, latest prices). Rows reach the strategy only after the
+    // engine's market data latency. Zero delivers every row.
+    void set_conflation(Duration interval) { conflation_ = interval; }
+    Duration conflation() const { return conflation_; }
     
     // Position tracking
     const std::unordered_map<InstrumentId, Position>& positions() const { return positions_; }
@@ -50,10 +174,64 @@ public:
     void set_active(bool active) { is_active_ = active; }
     
 protected:
+    // Slot of the instrument currently being delivered
+    size_t current_slot() const { return current_slot_; }
+    
+    // Last n values of a column, oldest first, ending at the tick being
+    // delivered: views into the data store, never later rows. Fewer than n
+    // when the run has not reached n rows yet. Covers every stored row, also
+    // those outside the strategy's session. Another instrument's history ends
+    // at its last row no later than the tick being delivered, whichever
+    // instrument the engine replays first.
+    std::span<const Price> history(Field field, size_t n) const {
+        return tail(price_column(current_slot_, field), visible_rows(current_slot_), n);
+    }
+    std::span<const Price> history(const InstrumentId& instrument, Field field, size_t n) const {
+        size_t slot = slot_of(instrument);
+        return tail(price_column(slot, field), visible_rows(slot), n);
+    }
+    std::span<const Volume> volume_history(size_t n) const {
+        const auto* ticks = slot_ticks_.at(current_slot_);
+        return tail(ticks ? ticks->volumes.data() : nullptr, visible_rows(current_slot_), n);
+    }
+    std::span<const Volume> volume_history(const InstrumentId& instrument, size_t n) const {
+        size_t slot = slot_of(instrument);
+        const auto* ticks = slot_ticks_.at(slot);
+        return tail(ticks ? ticks->volumes.data() : nullptr, visible_rows(slot), n);
+    }
+    // Price at the engine's current time rather than at the delivered tick:
+    // what an order placed now would trade against. The same as the tick's
+    // price unless market data latency or conflation delays delivery.
+    Price market_price(Field field = Field::Close) const {
+        const Price* column = price_column(current_slot_, field);
+        return column ? column[live_row_] : 0.0;
+    }
+    // Which of two levels the current bar reached first, from the finer data
+    // of just this bar (data.intrabar_files). Unknown without finer data, or
+    // when one finer row spans both levels too.
+    enum class Touch { Unknown, Low, High };
+    Touch first_touch(Price low_level, Price high_level) const;
+    
+    // Recurring timers, delivered to on_timer() with TimerEvent::handle(): due
+    // at first + k * period (the default aligns to multiples of period since
+    // the epoch) and fired on the slot's first replayed tick at or after
+    // that. Occurrences between two ticks fire once. Register them in
+    // on_start(); timers are not part of a checkpoint.
+    TimerHandle add_timer(size_t slot, Duration period, Timestamp first = Timestamp{});
+    // One timer per slot; the handles are consecutive in slot order
+    TimerHandle add_timers(Duration period, Timestamp first = Timestamp{});
+    void cancel_timer(TimerHandle handle);
+    
+    // Rows of the current instrument visible to history(); the event's row is history_length() - 1
+    size_t history_length() const {
+        return current_slot_ < slot_cursors_.size() ? slot_cursors_[current_slot_] : 0;
+    }
+    
     // Signal generation helpers
     void emit_signal(const InstrumentId& instrument, SignalEvent::SignalType signal_type, 
                     Price strength = 1.0) const;
-    void execute_order(const InstrumentId& instrument, Side side, Price price, Volume qty = 1) const;
+    // Fills at once at price; returns the order id
+    OrderId execute_order(const InstrumentId& instrument, Side side, Price price, Volume qty = 1) const;
     
     void emit_buy_signal(const InstrumentId& instrument, Price strength = 1.0) const {
         emit_signal(instrument, SignalEvent::SignalType::BUY, strength);
@@ -72,8 +250,64 @@ protected:
     Price unrealized_pnl_ = 0.0;
     size_t trade_count_ = 0;
     bool is_active_ = true;
+    std::vector<InstrumentId> subscriptions_;
+    std::unordered_map<InstrumentId, size_t> slot_index_;
+    std::vector<InstrumentId> slot_instruments_;
+    size_t current_slot_ = 0;
+    size_t live_row_ = 0;  // Store row at the engine's current time (market_price)
+    std::vector<const TickDataStore::TickData*> slot_ticks_;  // by slot
+    std::vector<size_t> slot_cursors_;  // Rows visible to history(), by slot
+    std::vector<std::shared_ptr<const IntrabarSource>> slot_intrabar_;  // by slot
+    TimerQueue* timer_queue_ = nullptr;
+    std::vector<size_t> slot_timer_lanes_;  // by slot
+    SessionSpec session_;
+    Duration conflation_{0};
     // REMOVE: mutable Logger logger_;
     // Use Logger::get() for logging in all strategies
+    
+private:
+    void advance_cursor(size_t slot, size_t tick_index) {
+        current_slot_ = slot;
+        if (slot < slot_cursors_.size()) slot_cursors_[slot] = tick_index + 1;
+    }
+    size_t slot_of(const InstrumentId& instrument) const {
+        auto it = slot_index_.find(instrument);
+        if (it == slot_index_.end()) throw std::out_of_range("No history for instrument: " + instrument);
+        return it->second;
+    }
+    const Price* price_column(size_t slot, Field field) const {
+        const auto* ticks = slot_ticks_.at(slot);
+        if (!ticks) return nullptr;
+        switch (field) {
+            case Field::Open: return ticks->open.data();
+            case Field::High: return ticks->high.data();
+            case Field::Low: return ticks->low.data();
+            case Field::Close: return ticks->close.data();
+            case Field::Last: return ticks->last_prices.data();
+            case Field::Bid: return ticks->bid_prices.data();
+            case Field::Ask: return ticks->ask_prices.data();
+        }
+        return nullptr;
+    }
+    // Rows of slot history() may read. Instruments replay one after another,
+    // so another slot's cursor can be anywhere; its rows are cut at the
+    // timestamp of the tick being delivered instead.
+    size_t visible_rows(size_t slot) const {
+        if (slot == current_slot_) return slot_cursors_[slot];
+        const auto* current = current_slot_ < slot_ticks_.size() ? slot_ticks_[current_slot_] : nullptr;
+        const auto* other = slot_ticks_.at(slot);
+        const size_t row = current_slot_ < slot_cursors_.size() ? slot_cursors_[current_slot_] : 0;
+        if (!current || !other || row == 0) return 0;
+        const Timestamp now = current->timestamps[row - 1];
+        return static_cast<size_t>(std::upper_bound(other->timestamps.begin(), other->timestamps.end(), now) -
+                                   other->timestamps.begin());
+    }
+    template <typename T>
+    std::span<const T> tail(const T* column, size_t end, size_t n) const {
+        if (!column) return {};
+        size_t count = std::min(n, end);
+        return std::span<const T>(column + end - count, count);
+    }
 };
 
 // Simple Moving Average Crossover Strategy
@@ -83,6 +317,7 @@ public:
     SMAStrategy(const StrategyId& strategy_id, int short_period, int long_period, PriceMode price_mode, std::unordered_map<std::string, std::string> price_columns)
         : StrategyBase(strategy_id), short_period_(short_period), long_period_(long_period), price_mode_(price_mode), price_columns_(std::move(price_columns)) {}
     ~SMAStrategy() override = default;
+    std::unique_ptr<StrategyBase> clone() const override { return std::make_unique<SMAStrategy>(*this); }
     void initialize() override;
     void on_market_data(const MarketEvent& event) override;
     void on_fill(const FillEvent& event) override;
@@ -96,7 +331,7 @@ private:
     int long_period_;
     PriceMode price_mode_;
     std::unordered_map<std::string, std::string> price_columns_;
-    std::unordered_map<InstrumentId, PriceHistory> price_histories_;
+    std::vector<PriceHistory> price_histories_;  // by slot
 };
 
 // Mean Reversion Strategy
@@ -106,6 +341,7 @@ public:
                          double threshold = 2.0)
         : StrategyBase(strategy_id), lookback_period_(lookback_period), threshold_(threshold) {}
     ~MeanReversionStrategy() override = default;
+    std::unique_ptr<StrategyBase> clone() const override { return std::make_unique<MeanReversionStrategy>(*this); }
     void initialize() override;
     void on_market_data(const MarketEvent& event) override;
     void on_fill(const FillEvent& event) override;
@@ -124,7 +360,7 @@ private:
     
     int lookback_period_;
     double threshold_;
-    std::unordered_map<InstrumentId, StatisticalData> statistical_data_;
+    std::vector<StatisticalData> statistical_data_;  // by slot
 };
 
 // Momentum Strategy
@@ -134,6 +370,7 @@ public:
                     double threshold = 0.02)
         : StrategyBase(strategy_id), lookback_period_(lookback_period), threshold_(threshold) {}
     ~MomentumStrategy() override = default;
+    std::unique_ptr<StrategyBase> clone() const override { return std::make_unique<MomentumStrategy>(*this); }
     void initialize() override;
     void on_market_data(const MarketEvent& event) override;
     void on_fill(const FillEvent& event) override;
@@ -150,7 +387,7 @@ private:
     
     int lookback_period_;
     double threshold_;
-    std::unordered_map<InstrumentId, MomentumData> momentum_data_;
+    std::vector<MomentumData> momentum_data_;  // by slot
 };
 
 // Strategy factory
@@ -167,6 +404,9 @@ namespace StrategyFactory {
     std::unique_ptr<StrategyBase> create_momentum_strategy(const StrategyId& id,
                                                          int lookback = 10,
                                                          double threshold = 0.02);
+    
+    // Build the strategy described by config.strategy
+    std::unique_ptr<StrategyBase> create_from_config(const Config& config);
 }
 
 } // namespace backtest
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace backtest {
+
+// Little helpers for the engine's binary files (run plans, cached results,
+// checkpoints): host-endian PODs and length-prefixed strings in one buffer.
+class BinaryWriter {
+public:
+    template<typename T>
+    void pod(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+    }
+    void str(const std::string& s) {
+        pod(static_cast<uint32_t>(s.size()));
+        buffer_.insert(buffer_.end(), s.begin(), s.end());
+    }
+    void raw(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+    template<typename T>
+    void vec(const std::vector<T>& values) {
+        pod(static_cast<uint64_t>(values.size()));
+        raw(values.data(), values.size() * sizeof(T));
+    }
+    const std::vector<char>& buffer() const { return buffer_; }
+
+private:
+    std::vector<char> buffer_;
+};
+
+// Throws std::runtime_error("<what> is truncated or corrupt") on overrun
+class BinaryReader {
+public:
+    BinaryReader(const std::vector<char>& buffer, std::string what)
+        : buffer_(buffer), what_(std::move(what)) {}
+
+    template<typename T>
+    T pod() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+    std::string str() {
+        auto size = pod<uint32_t>();
+        const char* data = take(size);
+        return std::string(data, size);
+    }
+    template<typename T>
+    std::vector<T> vec() {
+        auto count = pod<uint64_t>();
+        if (count > (buffer_.size() - offset_) / sizeof(T)) corrupt();
+        std::vector<T> values(count);
+        std::memcpy(values.data(), take(count * sizeof(T)), count * sizeof(T));
+        return values;
+    }
+    const char* take(size_t size) {
+        if (size > buffer_.size() - offset_) corrupt();
+        const char* data = buffer_.data() + offset_;
+        offset_ += size;
+        return data;
+    }
+    bool done() const { return offset_ == buffer_.size(); }
+    [[noreturn]] void corrupt() const { throw std::runtime_error(what_ + " is truncated or corrupt"); }
+
+private:
+    const std::vector<char>& buffer_;
+    std::string what_;
+    size_t offset_ = 0;
+};
+
+// Whole file as bytes; empty when it cannot be opened
+inline std::vector<char> read_binary_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return {};
+    return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+// Write aside and rename over path, so concurrent readers never see a partial file
+inline void replace_binary_file(const std::string& path, const std::vector<char>& bytes) {
+    const std::string temp = path + ".tmp" +
+        std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                       static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) throw std::runtime_error("Could not write " + temp);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    std::filesystem::rename(temp, path);
+}
+
+} // namespace backtest
@@ -1,10 +1,153 @@
 #pragma once
 
+#include "utils/types.h"
+#include "strategy/risk_manager.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <functional>
+
 namespace backtest {
 
+// Market data source: one CSV per instrument
+struct DataSourceConfig {
+    std::string path;
+    InstrumentId instrument = "AAPL";
+    std::string intrabar_path;  // Optional finer-grained CSV, read per bar on demand
+};
+
+// Commission and slippage settings used to build the CostModel
+struct CostConfig {
+    std::string slippage_model = "linear";  // "linear" or "sqrt"
+    Price slippage_base_rate = 0.0001;
+    Price slippage_impact = 0.01;
+    Price maker_fee_rate = 0.0;
+    Price taker_fee_rate = 0.001;
+    Price fixed_fee = 0.0;
+    Price min_commission = 0.0;
+    Price max_commission = 1000000.0;
+};
+
+// Exchange calendar driving session timers and daily resets; empty exchange disables it
+struct CalendarConfig {
+    std::string exchange;               // "NSE", "BSE", "NYSE", "NASDAQ", "CRYPTO"
+    std::vector<std::string> holidays;  // "YYYY-MM-DD"
+};
+
+struct LatencyConfig {
+    Duration market_data{std::chrono::microseconds(1)};
+    Duration order{std::chrono::microseconds(100)};
+};
+
+// Strategy type plus free-form numeric parameters ("short_ema", "rsi_period", ...)
+struct StrategyConfig {
+    std::string type = "simple_sma_broad";
+    StrategyId id = "strategy_1";
+    std::vector<InstrumentId> instruments;  // Subscriptions; empty means every instrument
+    std::string session;                    // "mon-fri 09:15-15:30"; empty keeps the strategy default
+    std::vector<std::string> holidays;      // "YYYY-MM-DD" dates excluded from the session
+    std::map<std::string, double> params;
+
+    double param(const std::string& name, double fallback) const {
+        auto it = params.find(name);
+        return (it != params.end()) ? it->second : fallback;
+    }
+};
+
+// Inclusive numeric range swept over a single config key
+struct SweepRange {
+    std::string key;
+    double start = 0.0;
+    double stop = 0.0;
+    double step = 1.0;
+
+    size_t count() const;
+    double value(size_t index) const { return start + step * static_cast<double>(index); }
+};
+
+// Typed configuration for a backtest run. Parsed once from a TOML subset:
+//
+//   [run]      initial_capital = 100000  cache_dir = ".nemo_cache"
+//   [data]     files = ["data/stock_data.csv"]  instruments = ["AAPL"]  shared_cache = "nemo_aapl"
+//              intrabar_files = ["data/stock_seconds.csv"]  huge_pages = "transparent"  numa = "replicate"
+//              archive = "ticks/"  from = "2024-03-01"  to = "2024-03-14"
+//   [cost]     taker_fee_rate = 0.001
+//   [risk]     max_order_size = 500
+//   [latency]  order_us = 100
+//   [calendar] exchange = "NSE"  holidays = ["2025-05-01"]
+//   [strategy] type = "simple_sma_broad"  instruments = ["AAPL"]  session = "09:15-15:30"
+//              warmup_ticks = 30  conflation_seconds = 300  short_ema = 9
+//   [sweep]    strategy.short_ema = [5, 20, 5]   # start, stop, step
+//
+// Keys are addressed as "section.name" by set_value/get_value.
 struct Config {
-    // Add configuration parameters here if needed in the future
-    // For now, it can be an empty struct as we are removing its direct usages
+    std::vector<DataSourceConfig> data;
+    std::string shared_cache;  // Shared-memory segment name; empty loads privately
+    std::string huge_pages = "off";  // Column pages: "off", "transparent", "reserved"
+    std::string numa = "off";        // "off", "interleave", "replicate"
+    std::string archive;  // Partitioned tick archive root; replaces data.files, data.instruments selects
+    std::string from;     // "YYYY-MM-DD[ HH:MM:SS]" bounds of the data loaded; empty is open
+    std::string to;
+    CostConfig cost;
+    RiskLimits risk;
+    LatencyConfig latency;
+    CalendarConfig calendar;
+    StrategyConfig strategy;
+    Price initial_capital = 10000.0;
+    std::string log_path = "logs/simpleSMABroad_trades.log";
+    std::string cache_dir;     // Result cache directory; empty disables caching
+    std::vector<SweepRange> sweeps;
+
+    static Config load_file(const std::string& path);
+    static Config parse(const std::string& text);
+
+    // Set a value by dotted key; throws std::invalid_argument on unknown keys
+    void set_value(const std::string& key, const std::string& value);
+    void set_number(const std::string& key, double value);
+    std::string get_value(const std::string& key) const;
+
+    // data.from / data.to as inclusive UTC nanoseconds; a bare date in
+    // data.to covers that whole day
+    std::pair<int64_t, int64_t> data_range() const;
+
+    // Every setting that can change a run's results, one "key=value" line each
+    // in a fixed order. Leaves out file locations (data files, log, shared
+    // cache, result cache) and sweeps.
+    std::string canonical_text() const;
+
+    // Resolve a numeric key to a setter once, for repeated application
+    using NumberSetter = std::function<void(Config&, double)>;
+    static NumberSetter number_setter(const std::string& key);
+};
+
+// Immutable binary expansion of a Config's sweeps. Compiled once by the
+// coordinator; workers load it and apply run i without touching TOML text.
+class RunPlan {
+public:
+    static RunPlan compile(const Config& base);
+    static RunPlan load(const std::string& path);
+    void save(const std::string& path) const;
+
+    size_t run_count() const { return run_count_; }
+    size_t param_count() const { return keys_.size(); }
+    const std::vector<std::string>& param_keys() const { return keys_; }
+    const double* run_values(size_t run) const { return values_.data() + run * keys_.size(); }
+    const Config& base() const { return base_; }
+
+    // Base config with run's swept parameters applied
+    Config config_for(size_t run) const;
+    void apply(size_t run, Config& config) const;
+
+private:
+    void resolve_setters();
+
+    Config base_;
+    size_t run_count_ = 1;
+    std::vector<std::string> keys_;
+    std::vector<double> values_;  // run-major: run_count_ x keys_.size()
+    std::vector<Config::NumberSetter> setters_;
 };
 
-}
+} // namespace backtest
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <new>
+
+namespace backtest {
+
+// Recycled blocks for coroutine frames. Frames are created and destroyed on
+// the replay thread, so each thread keeps its own free lists, one per 64-byte
+// size class; a frame of a finished coroutine is reused by the next one of
+// the same size without touching the global heap. Blocks above the largest
+// class go straight to operator new.
+class FramePool {
+public:
+    static void* allocate(size_t size) {
+        const size_t cls = size_class(size);
+        if (cls >= kClasses) return ::operator new(size);
+        auto& head = free_lists().heads[cls];
+        if (Node* node = head) {
+            head = node->next;
+            return node;
+        }
+        return ::operator new((cls + 1) * kGranule);
+    }
+
+    static void deallocate(void* block, size_t size) {
+        const size_t cls = size_class(size);
+        if (cls >= kClasses) {
+            ::operator delete(block);
+            return;
+        }
+        auto& head = free_lists().heads[cls];
+        head = new (block) Node{head};
+    }
+
+private:
+    static constexpr size_t kGranule = 64;
+    static constexpr size_t kClasses = 64;  // Up to 4 KB
+
+    struct Node {
+        Node* next;
+    };
+    struct FreeLists {
+        std::array<Node*, kClasses> heads{};
+        ~FreeLists() {
+            for (Node* head : heads) {
+                while (head) {
+                    Node* next = head->next;
+                    ::operator delete(head);
+                    head = next;
+                }
+            }
+        }
+    };
+
+    static size_t size_class(size_t size) { return size == 0 ? 0 : (size - 1) / kGranule; }
+    static FreeLists& free_lists() {
+        thread_local FreeLists lists;
+        return lists;
+    }
+};
+
+} // namespace backtest
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace backtest {
+
+// Streaming XXH64: fast non-cryptographic 64-bit hash fed in arbitrary
+// pieces. Digests match one-shot XXH64 of the concatenated input.
+class ContentHash {
+public:
+    explicit ContentHash(uint64_t seed = 0) { reset(seed); }
+
+    void reset(uint64_t seed = 0) {
+        seed_ = seed;
+        acc_[0] = seed + kPrime1 + kPrime2;
+        acc_[1] = seed + kPrime2;
+        acc_[2] = seed;
+        acc_[3] = seed - kPrime1;
+        total_ = 0;
+        buffered_ = 0;
+    }
+
+    void update(const void* data, size_t size) {
+        const auto* in = static_cast<const unsigned char*>(data);
+        total_ += size;
+        if (buffered_ + size < sizeof(buffer_)) {
+            std::memcpy(buffer_ + buffered_, in, size);
+            buffered_ += size;
+            return;
+        }
+        if (buffered_ > 0) {
+            const size_t fill = sizeof(buffer_) - buffered_;
+            std::memcpy(buffer_ + buffered_, in, fill);
+            consume(buffer_);
+            in += fill;
+            size -= fill;
+            buffered_ = 0;
+        }
+        for (; size >= sizeof(buffer_); in += sizeof(buffer_), size -= sizeof(buffer_)) consume(in);
+        std::memcpy(buffer_, in, size);
+        buffered_ = size;
+    }
+
+    template<typename T>
+    void update_value(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "hash raw bytes of trivially copyable values only");
+        update(&value, sizeof(T));
+    }
+
+    // Length-prefixed, so ("ab","c") and ("a","bc") differ
+    void update_string(std::string_view text) {
+        update_value(static_cast<uint64_t>(text.size()));
+        update(text.data(), text.size());
+    }
+
+    uint64_t digest() const {
+        uint64_t h;
+        if (total_ >= sizeof(buffer_)) {
+            h = rotl(acc_[0], 1) + rotl(acc_[1], 7) + rotl(acc_[2], 12) + rotl(acc_[3], 18);
+            for (uint64_t acc : acc_) h = (h ^ round(0, acc)) * kPrime1 + kPrime4;
+        } else {
+            h = seed_ + kPrime5;
+        }
+        h += total_;
+        const unsigned char* p = buffer_;
+        size_t left = buffered_;
+        for (; left >= 8; p += 8, left -= 8) h = rotl(h ^ round(0, read64(p)), 27) * kPrime1 + kPrime4;
+        if (left >= 4) {
+            uint32_t word;
+            std::memcpy(&word, p, sizeof(word));
+            h = rotl(h ^ (static_cast<uint64_t>(word) * kPrime1), 23) * kPrime2 + kPrime3;
+            p += 4;
+            left -= 4;
+        }
+        for (; left > 0; ++p, --left) h = rotl(h ^ (*p * kPrime5), 11) * kPrime1;
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // Fixed-width lowercase hex, usable as a file name
+    static std::string to_hex(uint64_t value) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex(16, '0');
+        for (size_t i = 16; i-- > 0; value >>= 4) hex[i] = digits[value & 0xF];
+        return hex;
+    }
+
+private:
+    static constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+    static uint64_t round(uint64_t acc, uint64_t input) { return rotl(acc + input * kPrime2, 31) * kPrime1; }
+    static uint64_t read64(const unsigned char* p) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        return word;
+    }
+
+    void consume(const unsigned char* stripe) {
+        for (size_t lane = 0; lane < 4; ++lane) acc_[lane] = round(acc_[lane], read64(stripe + 8 * lane));
+    }
+
+    uint64_t seed_ = 0;
+    uint64_t acc_[4] = {};
+    uint64_t total_ = 0;
+    unsigned char buffer_[32] = {};
+    size_t buffered_ = 0;
+};
+
+} // namespace backtest
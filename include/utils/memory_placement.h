@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace backtest {
+
+// Page size backing read-only market data
+enum class HugePages {
+    Off,          // Ordinary heap pages
+    Transparent,  // Anonymous mapping advised with MADV_HUGEPAGE
+    Reserved,     // MAP_HUGETLB from the reserved pool, transparent if the pool is empty
+};
+
+// Where on a multi-socket host the pages live
+enum class NumaPolicy {
+    Off,         // First touch
+    Interleave,  // Round-robin over every node
+    Replicate,   // One copy bound to the node of the reader (or of MemoryPlacement::node)
+};
+
+struct MemoryPlacement {
+    HugePages huge_pages = HugePages::Off;
+    NumaPolicy numa = NumaPolicy::Off;
+    int node = -1;  // Replicate target; -1 is the node the calling thread runs on
+
+    bool is_default() const { return huge_pages == HugePages::Off && numa == NumaPolicy::Off; }
+
+    // From the data.huge_pages ("off", "transparent", "reserved") and data.numa
+    // ("off", "interleave", "replicate") settings; throws std::invalid_argument
+    static MemoryPlacement parse(const std::string& huge_pages, const std::string& numa);
+};
+
+// Zeroed, writable memory laid out as placement asks, released when the last
+// owner goes. Settings the host cannot honour (no NUMA, no huge pages, not
+// Linux) fall back to ordinary pages with a warning, never an error.
+std::shared_ptr<char> allocate_placed(size_t bytes, const MemoryPlacement& placement);
+
+// NUMA topology from /sys; a host without it reports one node
+size_t numa_node_count();
+int current_numa_node();
+std::vector<int> numa_node_cpus(int node);
+
+// Restrict the calling thread to the CPUs of node; false if that failed
+bool pin_to_numa_node(int node);
+
+// Diagnostics for --bench-placement: bytes of the mapping holding addr that
+// sit on huge pages, and the share of pages in [addr, addr + bytes) that are
+// on the calling thread's node (1.0 where NUMA is unknown)
+size_t huge_page_bytes(const void* addr);
+double local_page_fraction(const void* addr, size_t bytes);
+
+// Resident set size of a process (0 = this one) from /proc; 0 if unknown
+size_t resident_bytes(long pid = 0);
+
+} // namespace backtest
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace backtest {
+
+// Hardware event counts of the calling thread through perf_event_open (Linux,
+// user space only). Each event is opened on its own, so a PMU that lacks one
+// (LLC or dTLB misses in many VMs) still reports the rest; events the kernel refuses
+// (perf_event_paranoid, containers, no PMU) read as absent, never as an error.
+// Counts are scaled up when the kernel had to multiplex counters.
+class PerfCounters {
+public:
+    enum Event : size_t {
+        Cycles,
+        Instructions,
+        L1DMisses,     // L1 data cache read misses
+        LLCMisses,     // Last-level cache misses
+        DTLBMisses,    // Data TLB read misses
+        BranchMisses,
+        TaskClock,     // CPU time in ns; a software event, so usually present
+        kEventCount
+    };
+
+    struct Reading {
+        std::array<uint64_t, kEventCount> values{};
+
+        uint64_t operator[](Event event) const { return values[event]; }
+        Reading operator-(const Reading& earlier) const {
+            Reading delta;
+            for (size_t e = 0; e < kEventCount; ++e) delta.values[e] = values[e] - earlier.values[e];
+            return delta;
+        }
+        Reading& operator+=(const Reading& other) {
+            for (size_t e = 0; e < kEventCount; ++e) values[e] += other.values[e];
+            return *this;
+        }
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool has(Event event) const { return fds_[event] >= 0; }
+    bool any_hardware() const;
+
+    // Counts since construction; absent events read zero
+    Reading read() const;
+
+    static const char* name(Event event);
+
+private:
+    std::array<int, kEventCount> fds_;
+};
+
+} // namespace backtest
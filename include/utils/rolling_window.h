@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+namespace backtest {
+
+// Most recent `capacity` values of a derived series, contiguous so they can be
+// handed out as a span. Storage is bounded at twice the capacity; the tail is
+// shifted down once it fills, which amortises to O(1) per push.
+template <typename T>
+class RollingWindow {
+public:
+    explicit RollingWindow(size_t capacity = 1) : capacity_(std::max<size_t>(capacity, 1)) {
+        values_.reserve(2 * capacity_);
+    }
+
+    void set_capacity(size_t capacity) {
+        capacity_ = std::max<size_t>(capacity, 1);
+        clear();
+        values_.reserve(2 * capacity_);
+    }
+
+    void push_back(const T& value) {
+        if (values_.size() == 2 * capacity_) {
+            values_.erase(values_.begin(), values_.end() - (capacity_ - 1));
+        }
+        values_.push_back(value);
+    }
+
+    void clear() { values_.clear(); }
+    bool empty() const { return values_.empty(); }
+    size_t size() const { return std::min(values_.size(), capacity_); }
+    size_t capacity() const { return capacity_; }
+
+    // Oldest first, at most capacity() values
+    std::span<const T> view() const {
+        return std::span<const T>(values_.data() + values_.size() - size(), size());
+    }
+
+private:
+    size_t capacity_;
+    std::vector<T> values_;
+};
+
+} // namespace backtest
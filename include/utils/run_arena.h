@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace backtest {
+
+// Memory for the containers of one engine's run. A monotonic resource over
+// one block: allocation is a pointer bump, freeing is a no-op, and teardown
+// drops everything at once. Blocks are kept per thread, so consecutive runs on
+// a sweep worker reuse the same memory without touching malloc or contending
+// with other threads. A run that outgrows its block spills to the heap, and
+// the thread's next block is sized to fit.
+class RunArena {
+public:
+    RunArena();
+    ~RunArena();
+    RunArena(const RunArena&) = delete;
+    RunArena& operator=(const RunArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &monotonic_; }
+    // Bytes obtained from the heap beyond the block
+    size_t spilled_bytes() const { return upstream_.bytes; }
+
+private:
+    explicit RunArena(std::pair<std::unique_ptr<std::byte[]>, size_t> block);
+
+    // Heap fallback that records how much the block was short
+    struct CountingResource : std::pmr::memory_resource {
+        size_t bytes = 0;
+        void* do_allocate(size_t size, size_t alignment) override {
+            bytes += size;
+            return std::pmr::new_delete_resource()->allocate(size, alignment);
+        }
+        void do_deallocate(void* p, size_t size, size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    std::unique_ptr<std::byte[]> block_;
+    size_t block_size_ = 0;
+    CountingResource upstream_;
+    std::pmr::monotonic_buffer_resource monotonic_;
+};
+
+} // namespace backtest
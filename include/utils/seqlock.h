@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace backtest {
+
+// Latest value of a trivially copyable T, written by one thread and read by
+// any number of others without locks. The writer never waits; a reader that
+// overlaps a write retries. The value is kept as relaxed atomic words, so a
+// torn read is detected by the sequence check rather than being a data race.
+// Before the first store, reads see T's bytes all zero. T may have default
+// member initializers; the bytes are copied through void* since trivially
+// copyable is all a byte copy needs.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock needs a trivially copyable value");
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+    // Single writer only
+    void store(const T& value) {
+        std::array<uint64_t, kWords> words{};
+        std::memcpy(words.data(), static_cast<const void*>(&value), sizeof(T));
+        const uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) data_[i].store(words[i], std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // False if a write was in progress
+    bool try_load(T& out) const {
+        const uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        std::array<uint64_t, kWords> words;
+        for (size_t i = 0; i < kWords; ++i) words[i] = data_[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) return false;
+        std::memcpy(static_cast<void*>(&out), words.data(), sizeof(T));
+        return true;
+    }
+
+    T load() const {
+        T value;
+        while (!try_load(value)) std::this_thread::yield();
+        return value;
+    }
+
+    // Number of stores so far
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    std::array<std::atomic<uint64_t>, kWords> data_{};
+};
+
+} // namespace backtest
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "utils/types.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace backtest {
+
+// Calendar arithmetic on proleptic Gregorian dates, no time zone database
+namespace TimeUtils {
+
+constexpr int64_t kNanosPerMinute = 60LL * 1000000000LL;
+constexpr int64_t kNanosPerDay = 24LL * 60LL * kNanosPerMinute;
+
+// Days since 1970-01-01 (Howard Hinnant's days_from_civil)
+constexpr int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// 0 = Sunday
+constexpr int weekday_from_days(int64_t days) {
+    return static_cast<int>(days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6);
+}
+
+// "YYYY-MM-DD" for a day number
+std::string format_date(int64_t days);
+
+// Day number of a "YYYY-MM-DD..." prefix; false if it is not a date
+bool parse_date(std::string_view text, int64_t& days);
+
+// "YYYY-MM-DD[ T]HH:MM[:SS[.fff]][Z|+HH:MM|-HH:MM]" to UTC nanoseconds.
+// Missing time means midnight, missing offset means UTC.
+bool parse_timestamp(std::string_view text, int64_t& epoch_ns);
+
+inline int64_t to_epoch_ns(Timestamp ts) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+}
+
+inline Timestamp from_epoch_ns(int64_t ns) {
+    return Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::nanoseconds(ns)));
+}
+
+} // namespace TimeUtils
+
+} // namespace backtest
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace backtest {
+
+// Timeline of a run in Chrome trace-event JSON, which chrome://tracing and
+// the Perfetto UI open directly. Each thread records into its own ring
+// buffer, so recording takes no lock and allocates nothing after the
+// thread's first event; when the buffer is full the oldest events go. While
+// tracing is off, a span costs one relaxed atomic load. Names must be string
+// literals (or otherwise outlive the trace), since only the pointer is kept.
+// Call start() and the writers while no other thread is recording.
+class Trace {
+public:
+    static constexpr size_t kDefaultEvents = 1 << 18;
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void start(size_t events_per_thread = kDefaultEvents);
+    static void stop() { enabled_.store(false, std::memory_order_relaxed); }
+
+    // Shown as the thread's track name
+    static void set_thread_name(const std::string& name);
+
+    static int64_t now_ns();
+    static void complete(const char* name, int64_t start_ns, int64_t end_ns);
+    static void counter(const char* name, int64_t value);
+    // Resident set size of the process as the "rss_bytes" counter
+    static void memory_counter();
+
+    // Whole trace. Fragments that other processes left for the same path
+    // (sweep workers) are merged in and removed.
+    static void write_json(const std::string& path);
+    // This process's events only, as a fragment of the trace at path
+    static void write_fragment(const std::string& path);
+
+private:
+    inline static std::atomic<bool> enabled_{false};
+};
+
+// Records [construction, destruction) as one span when tracing is on
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : name_(Trace::enabled() ? name : nullptr), start_ns_(name_ ? Trace::now_ns() : 0) {}
+    ~TraceSpan() {
+        if (name_) Trace::complete(name_, start_ns_, Trace::now_ns());
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    int64_t start_ns_;
+};
+
+} // namespace backtest
@@ -22,6 +22,7 @@ using Duration = std::chrono::nanoseconds;
 using Price = double;
 using Volume = uint64_t;
 using OrderId = uint64_t;
+using TimerHandle = uint32_t;  // Recurring timer of a run (StrategyBase::add_timer)
 using StrategyId = std::string;
 using InstrumentId = std::string;
 using ExchangeId = std::string;
@@ -59,12 +60,12 @@ enum class EventType : uint8_t {
 struct MarketDataTick {
     Timestamp timestamp;
     InstrumentId instrument;
-    Price bid_price;
-    Price ask_price;
-    Volume bid_size;
-    Volume ask_size;
-    Price last_price;
-    Volume volume;
+    Price bid_price = 0.0;
+    Price ask_price = 0.0;
+    Volume bid_size = 0;
+    Volume ask_size = 0;
+    Price last_price = 0.0;
+    Volume volume = 0;
     double open = 0.0;
     double high = 0.0;
     double low = 0.0;
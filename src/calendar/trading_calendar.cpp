@@ -0,0 +1,94 @@
+#include "calendar/trading_calendar.h"
+#include "utils/time_utils.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace backtest {
+
+TradingCalendar::TradingCalendar(std::string exchange, int utc_offset_minutes, TimeWindow hours,
+                                 uint8_t weekday_mask)
+    : exchange_(std::move(exchange)), utc_offset_minutes_(utc_offset_minutes),
+      hours_(hours), weekday_mask_(weekday_mask) {}
+
+TradingCalendar TradingCalendar::for_exchange(const std::string& exchange) {
+    // Hours are inclusive minutes; the last minute bar of a 15:30 close is stamped 15:29
+    if (exchange == "NSE" || exchange == "BSE") return TradingCalendar(exchange, 330, {9 * 60 + 15, 15 * 60 + 29});
+    if (exchange == "NYSE" || exchange == "NASDAQ") return TradingCalendar(exchange, -300, {9 * 60 + 30, 15 * 60 + 59});
+    if (exchange == "CRYPTO") return TradingCalendar(exchange, 0, {0, 24 * 60 - 1}, 0x7F);
+    throw std::invalid_argument("Unknown exchange calendar: " + exchange);
+}
+
+void TradingCalendar::add_holiday(const std::string& date) {
+    int64_t day;
+    if (!TimeUtils::parse_date(date, day)) throw std::invalid_argument("Invalid holiday date: " + date);
+    holidays_.insert(std::upper_bound(holidays_.begin(), holidays_.end(), day), day);
+}
+
+void TradingCalendar::build(Timestamp first, Timestamp last) {
+    open_ns_.clear();
+    close_ns_.clear();
+    session_day_.clear();
+    const int64_t offset_ns = utc_offset_minutes_ * TimeUtils::kNanosPerMinute;
+    const int64_t first_ns = TimeUtils::to_epoch_ns(first) + offset_ns;
+    const int64_t last_ns = TimeUtils::to_epoch_ns(last) + offset_ns;
+    if (last_ns < first_ns) return;
+
+    // Local day numbers, rounded toward negative infinity
+    auto local_day = [](int64_t ns) {
+        return ns >= 0 ? ns / TimeUtils::kNanosPerDay : -((-ns + TimeUtils::kNanosPerDay - 1) / TimeUtils::kNanosPerDay);
+    };
+    for (int64_t day = local_day(first_ns); day <= local_day(last_ns); ++day) {
+        if (!(weekday_mask_ & (1u << TimeUtils::weekday_from_days(day)))) continue;
+        if (std::binary_search(holidays_.begin(), holidays_.end(), day)) continue;
+        const int64_t midnight_utc = day * TimeUtils::kNanosPerDay - offset_ns;
+        open_ns_.push_back(midnight_utc + hours_.start_minute * TimeUtils::kNanosPerMinute);
+        close_ns_.push_back(midnight_utc + (hours_.end_minute + 1) * TimeUtils::kNanosPerMinute);
+        session_day_.push_back(day);
+    }
+}
+
+std::string TradingCalendar::session_date(size_t session) const {
+    return TimeUtils::format_date(session_day_.at(session));
+}
+
+int32_t TradingCalendar::session_of(int64_t epoch_ns) const {
+    auto it = std::upper_bound(open_ns_.begin(), open_ns_.end(), epoch_ns);
+    if (it == open_ns_.begin()) return -1;
+    const size_t session = static_cast<size_t>(it - open_ns_.begin()) - 1;
+    return epoch_ns < close_ns_[session] ? static_cast<int32_t>(session) : -1;
+}
+
+std::vector<int32_t> TradingCalendar::assign_sessions(const Timestamp* times, size_t count) const {
+    std::vector<int32_t> sessions(count, -1);
+    const size_t total = open_ns_.size();
+    size_t session = 0;
+    int64_t previous = INT64_MIN;
+    for (size_t i = 0; i < count; ++i) {
+        const int64_t t = TimeUtils::to_epoch_ns(times[i]);
+        if (t < previous) {
+            // Out-of-order tick: reposition with a search instead of rescanning
+            session = static_cast<size_t>(std::upper_bound(close_ns_.begin(), close_ns_.end(), t) - close_ns_.begin());
+        }
+        previous = t;
+        while (session < total && close_ns_[session] <= t) ++session;
+        if (session < total && t >= open_ns_[session]) sessions[i] = static_cast<int32_t>(session);
+    }
+    return sessions;
+}
+
+SessionIndex SessionIndex::build(const TradingCalendar& calendar, const TickDataStore::TickData& ticks) {
+    SessionIndex index;
+    index.session_of_tick = calendar.assign_sessions(ticks.timestamps.data(), ticks.size());
+    index.ticks_of_session.assign(calendar.session_count(), TickRange{});
+    for (size_t i = 0; i < index.session_of_tick.size(); ++i) {
+        const int32_t session = index.session_of_tick[i];
+        if (session < 0) continue;
+        auto& range = index.ticks_of_session[static_cast<size_t>(session)];
+        if (range.begin == range.end) range.begin = i;
+        range.end = i + 1;
+    }
+    return index;
+}
+
+} // namespace backtest
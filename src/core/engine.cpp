@@ -1,21 +1,38 @@
 #include "core/engine.h"
 #include "strategy/strategy_base.h"
+#include "data/tick_snapshot.h"
+#include "data/shared_tick_cache.h"
+#include "data/intrabar_source.h"
+#include "data_loader.h"
+#include "utils/config.h"
+#include "utils/binary_io.h"
+#include "utils/hash.h"
+#include "utils/time_utils.h"
+#include "utils/trace.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <optional>
 #include <utility>
 #include <stdexcept>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 
 namespace backtest {
 
-BacktestEngine::~BacktestEngine() = default;
+BacktestEngine::~BacktestEngine() {
+    stop_progress_monitor();
+}
 
 BacktestEngine::BacktestEngine() { // Removed Config dependency
     // Initialize core components
     event_bus_ = std::make_unique<EventBus>();
     sim_clock_ = std::make_shared<SimClock>();
-    data_store_ = std::make_unique<TickDataStore>();
+    data_store_ = std::make_shared<TickDataStore>();
     risk_manager_ = std::make_unique<RiskManager>();
-    cost_model_ = std::make_unique<CostModel>();
+    cost_model_ = std::make_shared<CostModel>();
     execution_handler_ = nullptr; // To be set up in initialize()
     order_router_ = nullptr;      // To be set up in initialize()
 }
@@ -26,7 +43,27 @@ void BacktestEngine::set_cost_model(std::unique_ptr<CostModel> cost_model) {
 
 void BacktestEngine::add_tick_data(const InstrumentId& instrument, const std::vector<MarketDataTick>& ticks) {
     if (!data_store_) throw std::runtime_error("TickDataStore not initialized");
-    data_store_->add_ticks(instrument, ticks);
+    mutable_store().add_ticks(instrument, ticks);
+}
+
+void BacktestEngine::save_snapshot(const std::string& path) const {
+    TraceSpan span("save_snapshot");
+    TickSnapshot::write_file(*data_store_, path);
+}
+
+void BacktestEngine::map_snapshot(const std::string& path) {
+    TraceSpan span("map_snapshot");
+    TickSnapshot::map_file(path, mutable_store());
+}
+
+void BacktestEngine::use_data(const TickDataStore& store) {
+    data_store_ = std::make_shared<TickDataStore>(store);
+}
+
+TickDataStore& BacktestEngine::mutable_store() {
+    // Forks share the store; the first writer takes a private copy
+    if (data_store_.use_count() > 1) data_store_ = std::make_shared<TickDataStore>(*data_store_);
+    return *data_store_;
 }
 
 void BacktestEngine::add_strategy(std::unique_ptr<StrategyBase> strategy) {
@@ -44,40 +81,148 @@ void BacktestEngine::initialize() {
     // Example: event_bus_ = std::make_unique<EventBus>();
 }
 
-void BacktestEngine::load_data(const std::string& filepath) {
-    std::ifstream file(filepath);
+void BacktestEngine::load_data(const std::string& filepath, const InstrumentId& instrument) {
+    read_csv(filepath, instrument, 0);
+}
+
+// Rows after byte offset (0 skips the header); remembers where reading stopped for checkpoints
+void BacktestEngine::read_csv(const std::string& filepath, const InstrumentId& instrument, uint64_t offset) {
+    TraceSpan span("read_csv");
+    std::ifstream file(filepath, std::ios::binary);
     if (!file.is_open()) throw std::runtime_error("Could not open data file: " + filepath);
-    std::string line;
+    file.seekg(static_cast<std::streamoff>(offset));
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
     std::vector<MarketDataTick> ticks;
-    std::getline(file, line); // skip header
-    while (std::getline(file, line)) {
-        std::istringstream ss(line);
-        std::string token;
-        MarketDataTick tick;
-        // CSV: date,open,high,low,close,volume,oi
-        std::getline(ss, tick.date, ',');
-        std::getline(ss, token, ','); tick.open = std::stod(token);
-        std::getline(ss, token, ','); tick.high = std::stod(token);
-        std::getline(ss, token, ','); tick.low = std::stod(token);
-        std::getline(ss, token, ','); tick.close = std::stod(token);
-        std::getline(ss, token, ','); tick.volume = std::stod(token);
-        std::getline(ss, token, ','); /* oi, ignore or store if needed */
-        // Set instrument (single instrument for now)
-        tick.instrument = "AAPL";
-        // Set last_price for compatibility
-        tick.last_price = tick.close;
-        // Set timestamp (optional: parse from date string)
-        tick.timestamp = Timestamp(); // You may want to parse actual time
-        ticks.push_back(tick);
+    size_t pos = 0;
+    std::optional<std::string> last_line;  // Raw text of the last line consumed
+    if (offset == 0) {
+        size_t end = text.find('\n');
+        last_line = text.substr(0, end);
+        pos = (end == std::string::npos) ? text.size() : end + 1;  // skip header
+    }
+    while (pos < text.size()) {
+        size_t end = std::min(text.find('\n', pos), text.size());
+        std::string line = text.substr(pos, end - pos);
+        pos = std::min(end + 1, text.size());
+        last_line = line;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        ticks.push_back(parse_bar_row(line, instrument, filepath));
     }
     if (!ticks.empty()) {
-        InstrumentId instrument = ticks[0].instrument;
         add_tick_data(instrument, ticks);
     }
+    
+    auto source = std::find_if(sources_.begin(), sources_.end(),
+                               [&filepath](const SourceProgress& p) { return p.path == filepath; });
+    if (source == sources_.end()) {
+        source = sources_.emplace(sources_.end());
+        source->path = filepath;
+        source->instrument = instrument;
+    }
+    source->offset = offset + pos;
+    if (last_line) source->last_line = *last_line;
+}
+
+void BacktestEngine::add_intrabar_source(const InstrumentId& instrument, const std::string& path) {
+    intrabar_[instrument] = std::make_shared<const IntrabarSource>(path, instrument);
+}
+
+namespace {
+
+// What a shared cache segment must have been loaded from: the archive and
+// range, and each source's path, instrument, size and modification time
+uint64_t source_fingerprint(const Config& config) {
+    ContentHash h;
+    h.update_string(config.archive);
+    h.update_string(config.from);
+    h.update_string(config.to);
+    for (const auto& source : config.data) {
+        h.update_string(source.path);
+        h.update_string(source.instrument);
+        std::error_code error;
+        h.update_value(static_cast<uint64_t>(std::filesystem::file_size(source.path, error)));
+        h.update_value(static_cast<int64_t>(std::filesystem::last_write_time(source.path, error).time_since_epoch().count()));
+    }
+    return h.digest();
+}
+
+} // namespace
+
+void BacktestEngine::load_data(const Config& config) {
+    TraceSpan span("load_data");
+    const auto counted = perf_read();
+    if (config.shared_cache.empty()) {
+        read_sources(config);
+    } else {
+        SharedTickCache::attach_or_publish(config.shared_cache, source_fingerprint(config), [&config](TickDataStore& store) {
+            BacktestEngine loader;
+            loader.read_sources(config);
+            store = loader.get_data_store();
+        }, mutable_store());
+    }
+    if (!config.archive.empty()) {
+        archive_root_ = config.archive;
+        archive_instruments_.clear();
+        for (const auto& source : config.data) archive_instruments_.push_back(source.instrument);
+    }
+    place_data(MemoryPlacement::parse(config.huge_pages, config.numa));
+    perf_add(Stage::Load, counted);
+}
+
+// CSV files, or the configured slice of an archive
+void BacktestEngine::read_sources(const Config& config) {
+    const auto [from_ns, to_ns] = config.data_range();
+    const Timestamp from = TimeUtils::from_epoch_ns(from_ns);
+    const Timestamp to = TimeUtils::from_epoch_ns(to_ns);
+    if (!config.archive.empty()) {
+        std::vector<InstrumentId> instruments;
+        for (const auto& source : config.data) instruments.push_back(source.instrument);
+        load_archive(config.archive, instruments, from, to);
+        return;
+    }
+    for (const auto& source : config.data) load_data(source.path, source.instrument);
+    if (!config.from.empty() || !config.to.empty()) {
+        data_store_ = std::make_shared<TickDataStore>(data_store_->slice(from, to));
+    }
+}
+
+TickArchive::ScanStats BacktestEngine::load_archive(const std::string& root, const std::vector<InstrumentId>& instruments,
+                                                    Timestamp start_time, Timestamp end_time) {
+    const auto started = std::chrono::steady_clock::now();
+    TickArchive::Query query{instruments, TimeUtils::to_epoch_ns(start_time), TimeUtils::to_epoch_ns(end_time)};
+    const auto stats = TickArchive::load(root, query, mutable_store());
+    archive_root_ = root;
+    archive_instruments_ = instruments;
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    Logger::get().info("BacktestEngine", "Archive " + root + ": " + std::to_string(stats.rows) + " rows from " +
+                       std::to_string(stats.partitions_read) + " partitions (" + std::to_string(stats.blocks_read) +
+                       " blocks read, " + std::to_string(stats.blocks_skipped) + " skipped) in " +
+                       std::to_string(ms) + " ms");
+    return stats;
+}
+
+const char* BacktestEngine::stage_name(Stage stage) {
+    switch (stage) {
+        case Stage::Load: return "load";
+        case Stage::Setup: return "setup";
+        case Stage::Replay: return "replay";
+        default: return "finish";
+    }
+}
+
+void BacktestEngine::enable_perf_counters(bool enable) {
+    if (!enable) perf_.reset();
+    else if (!perf_) perf_ = std::make_unique<PerfCounters>();
+}
+
+void BacktestEngine::place_data(const MemoryPlacement& placement) {
+    TraceSpan span("place_data");
+    if (!placement.is_default()) TickSnapshot::place(mutable_store(), placement);
 }
 
 void BacktestEngine::set_risk_limits(const RiskLimits& limits) {
-    // Set risk limits in risk_manager_
+    risk_manager_->set_limits(limits);
 }
 
 void BacktestEngine::configure_latency(Duration market_data_latency, Duration order_latency) {
@@ -85,33 +230,526 @@ void BacktestEngine::configure_latency(Duration market_data_latency, Duration or
     order_latency_ = order_latency;
 }
 
+void BacktestEngine::configure(const Config& config) {
+    auto cost_model = std::make_unique<CostModel>();
+    CommissionStructure commission;
+    commission.maker_fee_rate = config.cost.maker_fee_rate;
+    commission.taker_fee_rate = config.cost.taker_fee_rate;
+    commission.fixed_fee = config.cost.fixed_fee;
+    commission.min_commission = config.cost.min_commission;
+    commission.max_commission = config.cost.max_commission;
+    cost_model->set_commission_structure("default", commission);
+    if (config.cost.slippage_model == "sqrt") {
+        cost_model->set_slippage_model(std::make_unique<SqrtSlippageModel>(
+            config.cost.slippage_base_rate, config.cost.slippage_impact));
+    } else {
+        cost_model->set_slippage_model(std::make_unique<LinearSlippageModel>(
+            config.cost.slippage_base_rate, config.cost.slippage_impact));
+    }
+    set_cost_model(std::move(cost_model));
+    set_risk_limits(config.risk);
+    configure_latency(config.latency.market_data, config.latency.order);
+    
+    config_hash_ = [&config] {
+        ContentHash h;
+        h.update_string(config.canonical_text());
+        return h.digest();
+    }();
+    intrabar_.clear();
+    for (const auto& source : config.data) {
+        if (!source.intrabar_path.empty()) add_intrabar_source(source.instrument, source.intrabar_path);
+    }
+    calendar_ = TradingCalendar();
+    if (!config.calendar.exchange.empty()) {
+        calendar_ = TradingCalendar::for_exchange(config.calendar.exchange);
+        for (const auto& holiday : config.calendar.holidays) calendar_.add_holiday(holiday);
+    }
+}
+
 void BacktestEngine::run() {
+    if (!start()) return;
+    while (advance(kReplayBatch)) {}
+    finish();
+}
+
+bool BacktestEngine::start() {
     if (!data_store_ || strategies_.empty()) {
         Logger::get().error("engine", "No data or strategies loaded. Aborting run.");
-        return;
+        return false;
     }
+    run_started_ = std::chrono::steady_clock::now();
+    TraceSpan span("setup");
+    const auto counted = perf_read();
     is_running_ = true;
     is_paused_ = false;
     should_stop_ = false;
     Logger::get().info("engine", "Backtest started");
-    // Minimal event loop: for each tick, call on_market_data for each strategy
-    for (const auto& [instrument, ticks] : data_store_->get_all_ticks()) {
-        for (const auto& tick : ticks) {
-            if (should_stop_) break;
-            while (is_paused_) std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            MarketEvent event{tick};
-            for (auto& strat : strategies_) {
-                strat->on_market_data(event);
-            }
-            // Optionally: process signals, orders, fills, etc.
+    build_routes();
+    build_sessions();
+    for (auto& strat : strategies_) {
+        if (resume_states_.empty()) strat->initialize();
+        else restore_strategy(*strat);
+        strat->on_start();
+    }
+    replay_ = ReplayCursor{};
+    strategy_pnl_seen_.clear();
+    for (const auto& strat : strategies_) strategy_pnl_seen_.push_back(strat->get_total_pnl());
+    pnl_seen_ = strategies_pnl();
+    equity_sealed_.reset();
+    equity_tail_ = resume_equity_curve_;
+    equity_last_pnl_ = equity_tail_.empty() ? 0.0 : equity_tail_.back().pnl;
+    results_.equity_curve.clear();
+    progress_state_ = ProgressSnapshot{};
+    for (const auto& point : equity_tail_) {
+        progress_state_.peak_pnl = std::max(progress_state_.peak_pnl, point.pnl);
+        progress_state_.max_drawdown = std::max(progress_state_.max_drawdown, progress_state_.peak_pnl - point.pnl);
+    }
+    for (const auto& spans : route_spans_) {
+        for (const auto& span : spans) progress_state_.total_ticks += span.end - span.begin;
+    }
+    progress_state_.data_bytes = data_store_->memory_usage();
+    progress_due_tick_ = progress_every_ticks_ ? progress_every_ticks_ : std::numeric_limits<size_t>::max();
+    progress_.store(progress_state_);
+    enter_instrument(0);
+    perf_add(Stage::Setup, counted);
+    return true;
+}
+
+// Minimal event loop: each tick goes only to the strategies subscribed to its instrument,
+// and only inside its sessions; ticks outside every route's ranges are never materialized
+bool BacktestEngine::advance(size_t max_ticks) {
+    bool more = false;
+    {
+        TraceSpan span("replay");
+        const auto counted = perf_read();
+        more = replay(max_ticks);
+        perf_add(Stage::Replay, counted);
+    }
+    if (Trace::enabled()) {
+        Trace::counter("ticks_replayed", static_cast<int64_t>(replay_.delivered));
+        Trace::counter("equity_points", static_cast<int64_t>(equity_points()));
+        Trace::counter("arena_spill_bytes", static_cast<int64_t>(arena_.spilled_bytes()));
+        Trace::memory_counter();
+    }
+    return more;
+}
+
+bool BacktestEngine::replay(size_t max_ticks) {
+    size_t delivered = 0;
+    while (replay_.instrument < route_instruments_.size()) {
+        const size_t index = replay_.instrument;
+        const auto& spans = route_spans_[index];
+        if (routes_[index].empty() || replay_.span == spans.size() || should_stop_) {
+            if (replay_.session >= 0) end_session(replay_.session, routes_[index]);
+            enter_instrument(index + 1);
+            continue;
+        }
+        const TickRange& span = spans[replay_.span];
+        if (replay_.tick < span.begin) {
+            // Rows between spans belong to no route, so none of them is awaited
+            replay_.tick = span.begin;
+            replay_.visible = std::max(replay_.visible, span.begin);
         }
+        if (replay_.tick >= span.end) {
+            ++replay_.span;
+            continue;
+        }
+        if (delivered == max_ticks) return true;
+        ++delivered;
+        ++replay_.delivered;
+        deliver_tick(index, replay_.tick++);
     }
+    return false;
+}
+
+void BacktestEngine::finish() {
+    TraceSpan span("finish");
+    const auto counted = perf_read();
+    for (auto& strat : strategies_) {
+        strat->on_stop();
+    }
+    update_results();
+    results_.equity_curve = joined_equity_curve();
+    update_progress(replay_.now_ns, true);
+    perf_add(Stage::Finish, counted);
+    stats_.events_processed = replay_.delivered;
+    stats_.total_processing_time = std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - run_started_);
+    const double seconds = std::chrono::duration<double>(stats_.total_processing_time).count();
+    stats_.events_per_second = seconds > 0.0 ? static_cast<double>(stats_.events_processed) / seconds : 0.0;
     is_running_ = false;
     Logger::get().info("engine", "Backtest finished");
 }
 
+void BacktestEngine::enter_instrument(size_t index) {
+    replay_.instrument = index;
+    replay_.span = 0;
+    replay_.tick = 0;
+    if (index < route_instruments_.size()) {
+        auto resumed = resume_rows_.find(route_instruments_[index]);
+        if (resumed != resume_rows_.end()) replay_.tick = resumed->second;  // Carried-over rows were replayed before
+    }
+    replay_.session = -1;
+    replay_.route_cursors.assign(index < routes_.size() ? routes_[index].size() : 0, 0);
+    replay_.visible = replay_.tick;
+    replay_.route_pending.assign(replay_.route_cursors.size(), PendingRows{replay_.tick});
+    // Each instrument replays its own timeline; publish on its first tick
+    progress_due_ns_ = progress_every_ns_ ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+}
+
+void BacktestEngine::deliver_tick(size_t index, size_t i) {
+    while (is_paused_) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const auto& routes = routes_[index];
+    const InstrumentId& instrument = route_instruments_[index];
+    if (!calendar_.empty() && session_indexes_ && index < session_indexes_->size()) {
+        const int32_t session = (*session_indexes_)[index].session_of_tick[i];
+        if (session != replay_.session) {
+            if (replay_.session >= 0) end_session(replay_.session, routes);
+            replay_.session = session;
+            if (session >= 0) start_session(session, routes);
+        }
+    }
+    const auto* ticks = data_store_->get_ticks(instrument);
+    const int64_t now_ns = TimeUtils::to_epoch_ns(ticks->timestamps[i]);
+    replay_.now_ns = now_ns;
+    if (timers_.next_due_ns(index) <= now_ns) {
+        TraceSpan span("timers");
+        timers_.fire_due(index, now_ns, [](const TimerQueue::Timer& timer, TimerHandle handle, int64_t occurrence_ns) {
+            timer.strategy->dispatch_timer(TimerEvent(handle, TimeUtils::from_epoch_ns(occurrence_ns)), timer.slot);
+        });
+    }
+    // Strategies see a row market_data_latency_ after its timestamp: rows [0, visible)
+    const int64_t lag_ns = market_data_latency_.count();
+    size_t& visible = replay_.visible;
+    while (visible <= i && TimeUtils::to_epoch_ns(ticks->timestamps[visible]) + lag_ns <= now_ns) ++visible;
+    
+    bool loaded = false;  // Row i goes into tick_event_ once, for the routes that take it undelayed
+    auto current = [&]() -> const MarketEvent& {
+        if (!loaded) {
+            tick_event_.rewrite([&](MarketDataTick& tick) {
+                ticks->read_tick(i, tick);
+                tick.instrument = instrument;
+            });
+            loaded = true;
+        }
+        return tick_event_;
+    };
+    for (size_t r = 0; r < routes.size(); ++r) {
+        const auto& ranges = *routes[r].ranges;
+        size_t& cursor = replay_.route_cursors[r];
+        while (cursor < ranges.size() && ranges[cursor].end <= i) ++cursor;
+        if (cursor == ranges.size() || ranges[cursor].begin > i) continue;
+        TraceSpan span("strategy");
+        if (ranges[cursor].warmup) {
+            routes[r].strategy->dispatch_warmup_data(current(), routes[r].slot, i);
+        } else if (lag_ns > 0 || routes[r].conflation_ns > 0) {
+            deliver_delayed(index, r, ranges[cursor], i, now_ns);
+        } else {
+            routes[r].strategy->dispatch_market_data(current(), routes[r].slot, i);
+        }
+    }
+    for (const auto& route : routes) {
+        const Price now = route.strategy->get_total_pnl();
+        Price& seen = strategy_pnl_seen_[route.strategy_index];
+        if (now == seen) continue;
+        pnl_seen_ += now - seen;
+        seen = now;
+    }
+    const Price pnl = pnl_seen_;
+    if (pnl != equity_last_pnl_) {
+        equity_tail_.push_back(EquityPoint{ticks->timestamps[i], pnl});
+        equity_last_pnl_ = pnl;
+        progress_state_.peak_pnl = std::max(progress_state_.peak_pnl, pnl);
+        progress_state_.max_drawdown = std::max(progress_state_.max_drawdown, progress_state_.peak_pnl - pnl);
+    }
+    if (replay_.delivered >= progress_due_tick_ || now_ns >= progress_due_ns_) update_progress(now_ns);
+    // Optionally: process signals, orders, fills, etc.
+}
+
+namespace {
+
+// One update standing for rows [begin, end): latest prices, first open, extreme high/low, summed volume
+void conflate_rows(const TickDataStore::TickData& ticks, size_t begin, size_t end, MarketDataTick& update) {
+    ticks.read_tick(end - 1, update);
+    update.open = ticks.open[begin];
+    for (size_t row = begin; row + 1 < end; ++row) {
+        update.high = std::max(update.high, ticks.high[row]);
+        update.low = std::min(update.low, ticks.low[row]);
+        update.volume += ticks.volumes[row];
+    }
+}
+
+} // namespace
+
+// A route gets the rows that became visible since its last delivery, one by
+// one or, when conflating, as one update once it is ready. Rows still in flight
+// when a range ends arrive with its last row, so nothing crosses a session
+// boundary. The strategy's market_price() stays on row i.
+void BacktestEngine::deliver_delayed(size_t index, size_t r, const TickRange& range, size_t i, int64_t now_ns) {
+    const auto& route = routes_[index][r];
+    auto& pending = replay_.route_pending[r];
+    if (pending.first_row < range.begin) pending.first_row = range.begin;
+    const bool range_ends = i + 1 == range.end;
+    const size_t end = range_ends ? i + 1 : replay_.visible;
+    if (end <= pending.first_row) return;
+    
+    const auto& ticks = *data_store_->get_ticks(route_instruments_[index]);
+    if (route.conflation_ns > 0) {
+        if (now_ns < pending.ready_ns && !range_ends) return;
+        delayed_event_.rewrite([&](MarketDataTick& update) {
+            conflate_rows(ticks, pending.first_row, end, update);
+            update.instrument = route_instruments_[index];
+        });
+        route.strategy->dispatch_market_data(delayed_event_, route.slot, end - 1, i);
+        pending.ready_ns = now_ns + route.conflation_ns;
+    } else {
+        for (size_t row = pending.first_row; row < end; ++row) {
+            delayed_event_.rewrite([&](MarketDataTick& tick) {
+                ticks.read_tick(row, tick);
+                tick.instrument = route_instruments_[index];
+            });
+            route.strategy->dispatch_market_data(delayed_event_, route.slot, row, i);
+        }
+    }
+    pending.first_row = end;
+}
+
+std::unique_ptr<BacktestEngine> BacktestEngine::fork() const {
+    auto copy = std::make_unique<BacktestEngine>();
+    copy->data_store_ = data_store_;
+    copy->cost_model_ = cost_model_;
+    copy->risk_manager_ = std::make_unique<RiskManager>(*risk_manager_);
+    for (const auto& strat : strategies_) {
+        auto clone = strat->clone();
+        if (!clone) throw std::logic_error("Strategy " + strat->id() + " cannot be forked");
+        copy->strategies_.push_back(std::move(clone));
+    }
+    // Routes point at strategies by address; re-point them at the clones
+    copy->routes_ = routes_;
+    for (auto& routes : copy->routes_) {
+        for (auto& route : routes) {
+            auto it = std::find_if(strategies_.begin(), strategies_.end(),
+                                   [&route](const auto& strat) { return strat.get() == route.strategy; });
+            route.strategy = copy->strategies_[static_cast<size_t>(it - strategies_.begin())].get();
+        }
+    }
+    copy->timers_ = timers_;
+    for (size_t s = 0; s < strategies_.size(); ++s) {
+        copy->timers_.retarget(strategies_[s].get(), copy->strategies_[s].get());
+        copy->strategies_[s]->set_timer_queue(&copy->timers_);
+    }
+    copy->intrabar_ = intrabar_;
+    copy->route_instruments_ = route_instruments_;
+    copy->route_spans_ = route_spans_;
+    copy->session_ranges_ = session_ranges_;
+    copy->calendar_ = calendar_;
+    copy->session_indexes_ = session_indexes_;
+    copy->session_start_pnl_ = session_start_pnl_;
+    copy->risk_reset_sessions_ = risk_reset_sessions_;
+    copy->replay_ = replay_;
+    copy->resume_rows_ = resume_rows_;
+    copy->results_ = results_;
+    if (!equity_tail_.empty()) {
+        equity_sealed_ = std::make_shared<const EquitySegment>(equity_sealed_, std::move(equity_tail_));
+        equity_tail_.clear();
+    }
+    copy->equity_sealed_ = equity_sealed_;
+    copy->equity_last_pnl_ = equity_last_pnl_;
+    copy->strategy_pnl_seen_ = strategy_pnl_seen_;
+    copy->pnl_seen_ = pnl_seen_;
+    copy->progress_state_ = progress_state_;
+    copy->stats_ = stats_;
+    copy->market_data_latency_ = market_data_latency_;
+    copy->order_latency_ = order_latency_;
+    copy->is_running_ = is_running_.load();
+    return copy;
+}
+
+namespace {
+
+constexpr char kCheckpointMagic[8] = {'N', 'E', 'M', 'O', 'C', 'K', 'P', 'T'};
+constexpr uint32_t kCheckpointVersion = 1;
+
+} // namespace
+
+void BacktestEngine::save_checkpoint(const std::string& path) const {
+    TraceSpan span("save_checkpoint");
+    if (sources_.empty()) throw std::logic_error("Checkpoints need data read from CSV files, not a shared cache or snapshot");
+    size_t tail_rows = 1;
+    for (const auto& strat : strategies_) {
+        if (!strat->is_causal()) throw std::logic_error("Strategy " + strat->id() + " is not causal and cannot be checkpointed");
+        if (strat->conflation().count() > 0) throw std::logic_error("Strategy " + strat->id() + " uses conflated delivery, which is not checkpointed");
+        tail_rows = std::max({tail_rows, strat->history_rows(), strat->session().warmup_ticks});
+    }
+    
+    BinaryWriter out;
+    out.raw(kCheckpointMagic, sizeof(kCheckpointMagic));
+    out.pod(kCheckpointVersion);
+    out.pod(config_hash_);
+    out.pod(sessions_first_ns_);
+    out.pod(static_cast<uint64_t>(sources_.size()));
+    for (const auto& source : sources_) {
+        out.str(source.path);
+        out.str(source.instrument);
+        out.pod(source.offset);
+        out.str(source.last_line);
+    }
+    
+    // Trailing rows of every instrument, enough for each strategy's look-back
+    auto instruments = data_store_->get_instruments();
+    std::sort(instruments.begin(), instruments.end());
+    out.pod(static_cast<uint64_t>(instruments.size()));
+    for (const auto& instrument : instruments) {
+        const auto& ticks = *data_store_->get_ticks(instrument);
+        const size_t first = ticks.size() - std::min(ticks.size(), tail_rows);
+        out.str(instrument);
+        out.pod(static_cast<uint64_t>(ticks.size() - first));
+        for (size_t i = first; i < ticks.size(); ++i) {
+            auto tick = ticks.get_tick(i);
+            out.pod(TimeUtils::to_epoch_ns(tick.timestamp));
+            out.pod(tick.bid_price);
+            out.pod(tick.ask_price);
+            out.pod(tick.bid_size);
+            out.pod(tick.ask_size);
+            out.pod(tick.last_price);
+            out.pod(tick.volume);
+            out.pod(tick.open);
+            out.pod(tick.high);
+            out.pod(tick.low);
+            out.pod(tick.close);
+            out.str(tick.date);
+        }
+    }
+    
+    out.pod(static_cast<uint64_t>(strategies_.size()));
+    for (const auto& strat : strategies_) {
+        BinaryWriter state;
+        strat->save_state(state);
+        out.str(strat->id());
+        out.str(strat->version());
+        out.vec(state.buffer());
+    }
+    out.vec(results_.session_pnl);
+    const auto curve = joined_equity_curve();
+    out.pod(static_cast<uint64_t>(curve.size()));
+    for (const auto& point : curve) {
+        out.pod(TimeUtils::to_epoch_ns(point.time));
+        out.pod(point.pnl);
+    }
+    replace_binary_file(path, out.buffer());
+}
+
+size_t BacktestEngine::load_checkpoint(const std::string& path, const Config& config) {
+    if (!config.archive.empty() || !config.from.empty() || !config.to.empty()) {
+        throw std::runtime_error("Incremental runs read whole CSV files; data.archive, data.from and data.to are not supported");
+    }
+    auto buffer = read_binary_file(path);
+    BinaryReader in(buffer, "Checkpoint " + path);
+    if (std::memcmp(in.take(sizeof(kCheckpointMagic)), kCheckpointMagic, sizeof(kCheckpointMagic)) != 0 ||
+        in.pod<uint32_t>() != kCheckpointVersion) {
+        throw std::runtime_error("Not a checkpoint file: " + path);
+    }
+    if (in.pod<uint64_t>() != config_hash_) {
+        throw std::runtime_error("Checkpoint " + path + " was written with a different configuration");
+    }
+    sessions_first_ns_ = in.pod<int64_t>();
+    std::vector<SourceProgress> sources(in.pod<uint64_t>());
+    for (auto& source : sources) {
+        source.path = in.str();
+        source.instrument = in.str();
+        source.offset = in.pod<uint64_t>();
+        source.last_line = in.str();
+    }
+    
+    auto& store = mutable_store();
+    store.clear();
+    resume_rows_.clear();
+    for (auto count = in.pod<uint64_t>(); count > 0; --count) {
+        auto instrument = in.str();
+        std::vector<MarketDataTick> ticks(in.pod<uint64_t>());
+        for (auto& tick : ticks) {
+            tick.timestamp = TimeUtils::from_epoch_ns(in.pod<int64_t>());
+            tick.instrument = instrument;
+            tick.bid_price = in.pod<Price>();
+            tick.ask_price = in.pod<Price>();
+            tick.bid_size = in.pod<Volume>();
+            tick.ask_size = in.pod<Volume>();
+            tick.last_price = in.pod<Price>();
+            tick.volume = in.pod<Volume>();
+            tick.open = in.pod<double>();
+            tick.high = in.pod<double>();
+            tick.low = in.pod<double>();
+            tick.close = in.pod<double>();
+            tick.date = in.str();
+        }
+        resume_rows_[instrument] = ticks.size();
+        store.add_ticks(instrument, ticks);
+    }
+    
+    resume_states_.clear();
+    for (auto count = in.pod<uint64_t>(); count > 0; --count) {
+        auto id = in.str();
+        auto version = in.str();
+        resume_states_[id] = {std::move(version), in.vec<char>()};
+    }
+    resume_session_pnl_ = in.vec<Price>();
+    resume_equity_curve_.clear();
+    for (auto count = in.pod<uint64_t>(); count > 0; --count) {
+        const auto time = TimeUtils::from_epoch_ns(in.pod<int64_t>());
+        resume_equity_curve_.push_back(EquityPoint{time, in.pod<Price>()});
+    }
+    if (!in.done()) in.corrupt();
+    
+    // Only the bytes appended since; the line the checkpoint ended on must still be there
+    sources_.clear();
+    size_t appended = 0;
+    for (const auto& source : config.data) {
+        auto saved = std::find_if(sources.begin(), sources.end(),
+                                  [&source](const SourceProgress& p) { return p.path == source.path; });
+        if (saved == sources.end()) throw std::runtime_error("Checkpoint " + path + " has not read " + source.path);
+        std::ifstream file(source.path, std::ios::binary);
+        const uint64_t tail = std::min<uint64_t>(saved->offset, saved->last_line.size() + 1);
+        std::string ending(tail, '\0');
+        file.seekg(static_cast<std::streamoff>(saved->offset - tail));
+        if (file.read(ending.data(), static_cast<std::streamsize>(tail)) && !ending.empty() && ending.back() == '\n') {
+            ending.pop_back();
+        }
+        if (!file || !std::string_view(ending).ends_with(saved->last_line)) {
+            throw std::runtime_error("Data file changed before the checkpoint's end: " + source.path);
+        }
+        sources_.push_back(*saved);
+        const size_t before = store.size(source.instrument);
+        read_csv(source.path, source.instrument, saved->offset);
+        const size_t after = data_store_->size(source.instrument);
+        const auto* ticks = data_store_->get_ticks(source.instrument);
+        if (after > before && before > 0 && ticks->timestamps[before] <= ticks->timestamps[before - 1]) {
+            throw std::runtime_error("Rows appended to " + source.path + " do not follow the checkpoint");
+        }
+        appended += after - before;
+    }
+    return appended;
+}
+
+void BacktestEngine::restore_strategy(StrategyBase& strategy) {
+    auto saved = resume_states_.find(strategy.id());
+    if (saved == resume_states_.end()) throw std::runtime_error("Checkpoint has no state for strategy " + strategy.id());
+    if (saved->second.first != strategy.version()) {
+        throw std::runtime_error("Strategy " + strategy.id() + " changed version since the checkpoint");
+    }
+    BinaryReader in(saved->second.second, "Checkpoint state of " + strategy.id());
+    strategy.load_state(in);
+    if (!in.done()) in.corrupt();
+}
+
 void BacktestEngine::run_range(Timestamp start_time, Timestamp end_time) {
-    // Run backtest for a specific time range
+    if (!archive_root_.empty()) {
+        data_store_ = std::make_shared<TickDataStore>();
+        const std::string root = archive_root_;
+        const auto instruments = archive_instruments_;
+        load_archive(root, instruments, start_time, end_time);
+    } else {
+        data_store_ = std::make_shared<TickDataStore>(data_store_->slice(start_time, end_time));
+    }
+    run();
 }
 
 void BacktestEngine::pause() {
@@ -147,8 +785,209 @@ void BacktestEngine::process_order_event(const OrderEvent& event) {}
 void BacktestEngine::process_fill_event(const FillEvent& event) {}
 void BacktestEngine::process_risk_event(const RiskEvent& event) {}
 void BacktestEngine::advance_time_to(Timestamp target_time) {}
-void BacktestEngine::update_results() {}
-void BacktestEngine::update_progress() {}
+void BacktestEngine::update_results() {
+    results_.total_pnl = 0.0;
+    results_.total_trades = 0;
+    results_.strategy_pnl.clear();
+    for (const auto& strat : strategies_) {
+        results_.strategy_pnl[strat->id()] = strat->get_total_pnl();
+        results_.total_pnl += strat->get_total_pnl();
+        results_.total_trades += strat->get_trade_count();
+    }
+}
+void BacktestEngine::set_progress_interval(size_t ticks, Duration sim_time) {
+    progress_every_ticks_ = ticks;
+    progress_every_ns_ = sim_time.count();
+}
+
+// Runs on the replay thread only at the configured intervals, never per tick
+void BacktestEngine::update_progress(int64_t now_ns, bool done) {
+    auto& state = progress_state_;
+    state.ticks_replayed = replay_.delivered;
+    state.sim_time_ns = now_ns;
+    state.pnl = strategies_pnl();
+    state.trades = 0;
+    for (const auto& strat : strategies_) state.trades += strat->get_trade_count();
+    state.arena_spill_bytes = arena_.spilled_bytes();
+    state.done = done ? 1 : 0;
+    progress_.store(state);
+    if (progress_every_ticks_) progress_due_tick_ = replay_.delivered + progress_every_ticks_;
+    if (progress_every_ns_) progress_due_ns_ = now_ns + progress_every_ns_;
+}
+
+void BacktestEngine::start_progress_monitor(std::chrono::milliseconds period) {
+    stop_progress_monitor();
+    progress_monitor_stop_ = false;
+    progress_monitor_ = std::thread([this, period] {
+        uint64_t seen = progress_.version();
+        for (;;) {
+            const bool stopping = progress_monitor_stop_.load();
+            if (progress_.version() != seen) {
+                seen = progress_.version();
+                const ProgressSnapshot snapshot = progress_.load();
+                if (progress_callback_) progress_callback_(snapshot.fraction());
+                if (update_callback_) {
+                    BacktestResults partial;
+                    partial.total_pnl = snapshot.pnl;
+                    partial.total_trades = snapshot.trades;
+                    partial.max_drawdown = snapshot.max_drawdown;
+                    partial.max_profit = snapshot.peak_pnl;
+                    update_callback_(partial);
+                }
+                if (snapshot.done) break;
+            }
+            if (stopping) break;
+            std::this_thread::sleep_for(period);
+        }
+    });
+}
+
+void BacktestEngine::stop_progress_monitor() {
+    if (!progress_monitor_.joinable()) return;
+    progress_monitor_stop_ = true;
+    progress_monitor_.join();
+}
+void BacktestEngine::build_sessions() {
+    session_indexes_.reset();
+    results_.session_pnl.clear();
+    if (calendar_.empty()) return;
+    
+    // One calendar spanning every instrument, then one merge pass per instrument
+    bool any = false;
+    Timestamp first{}, last{};
+    for (const auto& instrument : route_instruments_) {
+        const auto* ticks = data_store_->get_ticks(instrument);
+        if (!ticks || ticks->size() == 0) continue;
+        auto [lo, hi] = std::minmax_element(ticks->timestamps.begin(), ticks->timestamps.end());
+        first = any ? std::min(first, *lo) : *lo;
+        last = any ? std::max(last, *hi) : *hi;
+        any = true;
+    }
+    if (!any) return;
+    // A resumed run keeps the session ids of the run it continues
+    sessions_first_ns_ = std::min(sessions_first_ns_, TimeUtils::to_epoch_ns(first));
+    calendar_.build(TimeUtils::from_epoch_ns(sessions_first_ns_), last);
+    std::vector<SessionIndex> indexes;
+    for (const auto& instrument : route_instruments_) {
+        indexes.push_back(SessionIndex::build(calendar_, *data_store_->get_ticks(instrument)));
+    }
+    session_indexes_ = std::make_shared<const std::vector<SessionIndex>>(std::move(indexes));
+    results_.session_pnl.assign(calendar_.session_count(), 0.0);
+    risk_reset_sessions_.assign(calendar_.session_count(), false);
+    std::copy_n(resume_session_pnl_.begin(), std::min(resume_session_pnl_.size(), results_.session_pnl.size()),
+                results_.session_pnl.begin());
+}
+const SessionIndex* BacktestEngine::get_session_index(const InstrumentId& instrument) const {
+    auto it = std::lower_bound(route_instruments_.begin(), route_instruments_.end(), instrument);
+    if (it == route_instruments_.end() || *it != instrument) return nullptr;
+    size_t index = static_cast<size_t>(it - route_instruments_.begin());
+    return (session_indexes_ && index < session_indexes_->size()) ? &(*session_indexes_)[index] : nullptr;
+}
+void BacktestEngine::start_session(int32_t session, const RouteList& routes) {
+    if (!risk_reset_sessions_[session]) {
+        risk_manager_->reset_daily_counters();
+        risk_reset_sessions_[session] = true;
+    }
+    session_start_pnl_ = strategies_pnl();
+    TimerEvent event(kSessionStartTimer, TimeUtils::from_epoch_ns(calendar_.open_ns()[session]));
+    for (const auto& route : routes) route.strategy->dispatch_timer(event, route.slot);
+}
+void BacktestEngine::end_session(int32_t session, const RouteList& routes) {
+    TimerEvent event(kSessionEndTimer, TimeUtils::from_epoch_ns(calendar_.close_ns()[session]));
+    for (const auto& route : routes) route.strategy->dispatch_timer(event, route.slot);
+    results_.session_pnl[session] += strategies_pnl() - session_start_pnl_;
+}
+Price BacktestEngine::strategies_pnl() const {
+    Price total = 0.0;
+    for (const auto& strat : strategies_) total += strat->get_total_pnl();
+    return total;
+}
+
+BacktestEngine::EquitySegment::EquitySegment(std::shared_ptr<const EquitySegment> before, std::vector<EquityPoint> sealed)
+    : previous(std::move(before)), points(std::move(sealed)) {
+    total = points.size() + (previous ? previous->total : 0);
+}
+
+// A long run forks once per checkpoint; unlink the chain in a loop rather than
+// one nested destructor per segment
+BacktestEngine::EquitySegment::~EquitySegment() {
+    auto next = std::move(previous);
+    while (next && next.use_count() == 1) next = std::move(next->previous);
+}
+
+size_t BacktestEngine::equity_points() const {
+    return (equity_sealed_ ? equity_sealed_->total : 0) + equity_tail_.size();
+}
+
+std::vector<BacktestEngine::EquityPoint> BacktestEngine::joined_equity_curve() const {
+    std::vector<EquityPoint> curve(equity_points());
+    auto end = curve.end() - static_cast<std::ptrdiff_t>(equity_tail_.size());
+    std::copy(equity_tail_.begin(), equity_tail_.end(), end);
+    for (const EquitySegment* segment = equity_sealed_.get(); segment; segment = segment->previous.get()) {
+        end = std::copy_backward(segment->points.begin(), segment->points.end(), end);
+    }
+    return curve;
+}
+
+void BacktestEngine::build_routes() {
+    route_instruments_ = data_store_->get_instruments();
+    std::sort(route_instruments_.begin(), route_instruments_.end());
+    routes_.assign(route_instruments_.size(), {});
+    session_ranges_.clear();
+    timers_.reset(route_instruments_.size());
+    std::unordered_map<InstrumentId, size_t> instrument_index;
+    for (size_t i = 0; i < route_instruments_.size(); ++i) instrument_index[route_instruments_[i]] = i;
+    
+    // Session ranges are computed once per (instrument, session) and shared by every strategy using them
+    auto ranges_for = [this](size_t index, const SessionSpec& session) {
+        const InstrumentId& instrument = route_instruments_[index];
+        auto [it, inserted] = session_ranges_.try_emplace(instrument + "|" + session.key());
+        if (inserted) {
+            it->second = std::make_shared<const std::vector<TickRange>>(
+                SessionFilter::build_ranges(*data_store_->get_ticks(instrument), session));
+        }
+        return it->second.get();
+    };
+    
+    for (size_t s = 0; s < strategies_.size(); ++s) {
+        auto& strat = strategies_[s];
+        strat->clear_slots();
+        if (strat->subscriptions().empty()) {
+            for (size_t i = 0; i < route_instruments_.size(); ++i) {
+                routes_[i].push_back({strat.get(), strat->assign_slot(route_instruments_[i]),
+                                      ranges_for(i, strat->session()), strat->conflation().count(), s});
+            }
+        } else {
+            // Slots follow subscription order, including instruments with no data
+            for (const auto& instrument : strat->subscriptions()) {
+                size_t slot = strat->assign_slot(instrument);
+                auto it = instrument_index.find(instrument);
+                if (it != instrument_index.end()) {
+                    routes_[it->second].push_back({strat.get(), slot, ranges_for(it->second, strat->session()),
+                                                   strat->conflation().count(), s});
+                } else {
+                    Logger::get().warn("engine", strat->id() + " subscribed to " + instrument + " which has no data");
+                }
+            }
+        }
+        for (size_t slot = 0; slot < strat->slot_count(); ++slot) {
+            strat->bind_slot_data(slot, data_store_->get_ticks(strat->slot_instrument(slot)));
+            auto fine = intrabar_.find(strat->slot_instrument(slot));
+            strat->bind_slot_intrabar(slot, fine != intrabar_.end() ? fine->second : nullptr);
+            auto lane = instrument_index.find(strat->slot_instrument(slot));
+            strat->bind_slot_timers(slot, lane != instrument_index.end() ? lane->second : TimerQueue::kNoLane);
+        }
+        strat->set_timer_queue(&timers_);
+    }
+    
+    route_spans_.assign(route_instruments_.size(), {});
+    for (size_t i = 0; i < route_instruments_.size(); ++i) {
+        std::vector<const std::vector<TickRange>*> lists;
+        for (const auto& route : routes_[i]) lists.push_back(route.ranges);
+        const auto spans = SessionFilter::merge(lists);
+        route_spans_[i].assign(spans.begin(), spans.end());
+    }
+}
 void BacktestEngine::setup_event_handlers() {}
 void BacktestEngine::create_order_books() {}
 void BacktestEngine::validate_configuration() {}
@@ -0,0 +1,141 @@
+#include "core/result_cache.h"
+#include "utils/binary_io.h"
+#include "utils/hash.h"
+#include "utils/trace.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace backtest {
+
+namespace {
+
+constexpr char kResultMagic[8] = {'N', 'E', 'M', 'O', 'R', 'S', 'L', 'T'};
+// Bump when the file layout or the meaning of a stored field changes
+constexpr uint32_t kResultVersion = 1;
+constexpr const char* kResultExtension = ".result";
+
+void decode(const std::vector<char>& buffer, uint64_t key, BacktestEngine::BacktestResults& results) {
+    BinaryReader in(buffer, "Result cache entry");
+    if (std::memcmp(in.take(sizeof(kResultMagic)), kResultMagic, sizeof(kResultMagic)) != 0 ||
+        in.pod<uint32_t>() != kResultVersion || in.pod<uint64_t>() != key) {
+        in.corrupt();
+    }
+    results.total_pnl = in.pod<Price>();
+    results.total_commission = in.pod<Price>();
+    results.total_slippage = in.pod<Price>();
+    results.total_trades = in.pod<uint64_t>();
+    results.winning_trades = in.pod<uint64_t>();
+    results.losing_trades = in.pod<uint64_t>();
+    results.max_drawdown = in.pod<Price>();
+    results.max_profit = in.pod<Price>();
+    results.sharpe_ratio = in.pod<Price>();
+    for (auto count = in.pod<uint64_t>(); count > 0; --count) {
+        auto id = in.str();
+        results.strategy_pnl[id] = in.pod<Price>();
+    }
+    results.session_pnl = in.vec<Price>();
+    for (auto count = in.pod<uint64_t>(); count > 0; --count) {
+        const auto ns = in.pod<int64_t>();
+        results.equity_curve.push_back(BacktestEngine::EquityPoint{Timestamp(Duration(ns)), in.pod<Price>()});
+    }
+    if (!in.done()) in.corrupt();
+}
+
+// Streamed in chunks; intrabar files can be far larger than the bars
+void hash_file(ContentHash& h, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open intrabar file: " + path);
+    std::vector<char> chunk(64 * 1024);
+    while (file.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || file.gcount() > 0) {
+        h.update(chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+}
+
+} // namespace
+
+ResultCache::ResultCache(std::string directory) : directory_(std::move(directory)) {}
+
+uint64_t ResultCache::key(const TickDataStore& store, const Config& config, const std::string& strategy_version) {
+    ContentHash h;
+    h.update_value(kResultVersion);
+    h.update_value(store.content_hash());
+    h.update_string(config.canonical_text());
+    // Intrabar files are read during the run, not loaded into the store
+    for (const auto& source : config.data) {
+        if (!source.intrabar_path.empty()) hash_file(h, source.intrabar_path);
+    }
+    h.update_string(strategy_version);
+    return h.digest();
+}
+
+std::string ResultCache::path_for(uint64_t key) const {
+    return (std::filesystem::path(directory_) / (ContentHash::to_hex(key) + kResultExtension)).string();
+}
+
+std::optional<BacktestEngine::BacktestResults> ResultCache::lookup(uint64_t key) const {
+    auto buffer = read_binary_file(path_for(key));
+    if (buffer.empty()) return std::nullopt;
+    BacktestEngine::BacktestResults results;
+    try {
+        decode(buffer, key, results);
+    } catch (const std::runtime_error&) {
+        // A damaged or foreign entry is just a miss
+        Logger::get().warn("result_cache", "Ignoring unreadable cache entry " + path_for(key));
+        return std::nullopt;
+    }
+    return results;
+}
+
+void ResultCache::store(uint64_t key, const BacktestEngine::BacktestResults& results) const {
+    TraceSpan span("cache_store");
+    BinaryWriter out;
+    out.raw(kResultMagic, sizeof(kResultMagic));
+    out.pod(kResultVersion);
+    out.pod(key);
+    out.pod(results.total_pnl);
+    out.pod(results.total_commission);
+    out.pod(results.total_slippage);
+    out.pod(static_cast<uint64_t>(results.total_trades));
+    out.pod(static_cast<uint64_t>(results.winning_trades));
+    out.pod(static_cast<uint64_t>(results.losing_trades));
+    out.pod(results.max_drawdown);
+    out.pod(results.max_profit);
+    out.pod(results.sharpe_ratio);
+
+    std::vector<std::pair<StrategyId, Price>> strategies(results.strategy_pnl.begin(), results.strategy_pnl.end());
+    std::sort(strategies.begin(), strategies.end());
+    out.pod(static_cast<uint64_t>(strategies.size()));
+    for (const auto& [id, pnl] : strategies) {
+        out.str(id);
+        out.pod(pnl);
+    }
+    out.vec(results.session_pnl);
+    out.pod(static_cast<uint64_t>(results.equity_curve.size()));
+    for (const auto& point : results.equity_curve) {
+        out.pod(static_cast<int64_t>(std::chrono::duration_cast<Duration>(point.time.time_since_epoch()).count()));
+        out.pod(point.pnl);
+    }
+
+    std::filesystem::create_directories(directory_);
+    replace_binary_file(path_for(key), out.buffer());
+}
+
+bool ResultCache::invalidate(uint64_t key) const {
+    std::error_code ec;
+    return std::filesystem::remove(path_for(key), ec);
+}
+
+size_t ResultCache::clear() const {
+    std::error_code ec;
+    size_t removed = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+        if (entry.path().extension() == kResultExtension && std::filesystem::remove(entry.path(), ec)) ++removed;
+    }
+    return removed;
+}
+
+} // namespace backtest
@@ -0,0 +1,54 @@
+#include "core/timer_queue.h"
+#include "core/events.h"
+#include <stdexcept>
+
+namespace backtest {
+
+void TimerQueue::reset(size_t lanes) {
+    timers_.clear();
+    lanes_.clear();
+    lanes_.resize(lanes);
+    spare_.clear();
+}
+
+TimerHandle TimerQueue::add(StrategyBase* strategy, size_t slot, size_t lane, int64_t first_ns, int64_t period_ns) {
+    if (period_ns <= 0) throw std::invalid_argument("Timer period must be positive");
+    if (timers_.size() >= TimerEvent::kNoHandle) throw std::length_error("Too many timers");
+    const auto handle = static_cast<TimerHandle>(timers_.size());
+    const bool fires = lane < lanes_.size();
+    timers_.push_back(Timer{strategy, slot, lane, period_ns, fires});
+    if (fires) schedule(lane, first_ns, handle);
+    return handle;
+}
+
+void TimerQueue::cancel(TimerHandle handle) {
+    // Dropped from its bucket when that comes due
+    if (handle < timers_.size()) timers_[handle].active = false;
+}
+
+void TimerQueue::retarget(const StrategyBase* from, StrategyBase* to) {
+    for (auto& timer : timers_) {
+        if (timer.strategy == from) timer.strategy = to;
+    }
+}
+
+void TimerQueue::schedule(size_t lane, int64_t due_ns, TimerHandle handle) {
+    auto& heap = lanes_[lane];
+    // Few distinct due times are pending at once; a batch lands in one bucket
+    for (auto& bucket : heap) {
+        if (bucket.due_ns == due_ns) {
+            bucket.timers.push_back(handle);
+            return;
+        }
+    }
+    Bucket bucket{due_ns, std::pmr::vector<TimerHandle>(lanes_.get_allocator())};
+    if (!spare_.empty()) {
+        bucket.timers = std::move(spare_.back());
+        spare_.pop_back();
+    }
+    bucket.timers.push_back(handle);
+    heap.push_back(std::move(bucket));
+    std::push_heap(heap.begin(), heap.end(), later);
+}
+
+} // namespace backtest
@@ -1,9 +1,11 @@
 #include "data_loader.h"
+#include "utils/time_utils.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <vector>
 #include <map>
+#include <stdexcept>
 
 std::vector<DataPoint> DataLoader::load_data(const std::string& file_path) {
     std::vector<DataPoint> data;
@@ -45,3 +47,31 @@ std::vector<DataPoint> DataLoader::load_data(const std::string& file_path) {
     file.close();
     return data;
 }
+
+namespace backtest {
+
+MarketDataTick parse_bar_row(const std::string& line, const InstrumentId& instrument, const std::string& source) {
+    std::istringstream ss(line);
+    std::string token;
+    MarketDataTick tick;
+    // CSV: date,open,high,low,close,volume,oi
+    std::getline(ss, tick.date, ',');
+    std::getline(ss, token, ','); tick.open = std::stod(token);
+    std::getline(ss, token, ','); tick.high = std::stod(token);
+    std::getline(ss, token, ','); tick.low = std::stod(token);
+    std::getline(ss, token, ','); tick.close = std::stod(token);
+    std::getline(ss, token, ','); tick.volume = std::stod(token);
+    std::getline(ss, token, ','); /* oi, ignore or store if needed */
+    tick.instrument = instrument;
+    // Set last_price for compatibility
+    tick.last_price = tick.close;
+    // Dates carry their UTC offset ("2025-05-12 09:15:00+05:30")
+    int64_t epoch_ns = 0;
+    if (!TimeUtils::parse_timestamp(tick.date, epoch_ns)) {
+        throw std::runtime_error("Unparseable date '" + tick.date + "' in " + source);
+    }
+    tick.timestamp = TimeUtils::from_epoch_ns(epoch_ns);
+    return tick;
+}
+
+} // namespace backtest
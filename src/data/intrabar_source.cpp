@@ -0,0 +1,75 @@
+#include "data/intrabar_source.h"
+#include "data_loader.h"
+#include "utils/time_utils.h"
+#include <fstream>
+#include <stdexcept>
+
+namespace backtest {
+
+namespace {
+
+// Below this many bytes the search range is scanned line by line
+constexpr int64_t kScanBytes = 16 * 1024;
+
+// Start of the first line at or after offset (offset itself if a line starts there)
+int64_t line_start_at(std::ifstream& file, int64_t offset) {
+    file.clear();
+    file.seekg(offset - 1);
+    std::string skipped;
+    std::getline(file, skipped);
+    return file ? static_cast<int64_t>(file.tellg()) : -1;
+}
+
+int64_t row_time(const std::string& line, const std::string& path) {
+    const std::string date = line.substr(0, line.find(','));
+    int64_t epoch_ns = 0;
+    if (!TimeUtils::parse_timestamp(date, epoch_ns)) {
+        throw std::runtime_error("Unparseable date '" + date + "' in " + path);
+    }
+    return epoch_ns;
+}
+
+} // namespace
+
+IntrabarSource::IntrabarSource(std::string path, InstrumentId instrument)
+    : path_(std::move(path)), instrument_(std::move(instrument)) {
+    if (!std::ifstream(path_).is_open()) throw std::runtime_error("Could not open intrabar file: " + path_);
+}
+
+std::vector<MarketDataTick> IntrabarSource::rows_between(int64_t from_ns, int64_t to_ns) const {
+    std::ifstream file(path_, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open intrabar file: " + path_);
+    std::string line;
+    std::getline(file, line);  // header
+    int64_t lo = file.tellg();
+    file.seekg(0, std::ios::end);
+    int64_t hi = file.tellg();
+
+    // Lines starting before lo are all earlier than from_ns; the first line at
+    // or after from_ns starts no later than hi
+    while (lo >= 0 && hi - lo > kScanBytes) {
+        const int64_t mid = lo + (hi - lo) / 2;
+        const int64_t start = line_start_at(file, mid);
+        if (start < 0 || start >= hi || !std::getline(file, line)) {
+            hi = mid;
+        } else if (row_time(line, path_) < from_ns) {
+            lo = start;
+        } else {
+            hi = start;
+        }
+    }
+
+    std::vector<MarketDataTick> rows;
+    file.clear();
+    file.seekg(lo);
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        const int64_t time = row_time(line, path_);
+        if (time >= to_ns) break;
+        if (time >= from_ns) rows.push_back(parse_bar_row(line, instrument_, path_));
+    }
+    return rows;
+}
+
+} // namespace backtest
@@ -0,0 +1,181 @@
+#include "data/session_filter.h"
+#include "utils/time_utils.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+namespace backtest {
+
+namespace {
+
+constexpr const char* kDayNames[] = {"sun", "mon", "tue", "wed", "thu", "fri", "sat"};
+
+int two_digits(std::string_view text, size_t pos) {
+    if (pos + 2 > text.size() || !std::isdigit(static_cast<unsigned char>(text[pos])) ||
+        !std::isdigit(static_cast<unsigned char>(text[pos + 1]))) {
+        return -1;
+    }
+    return (text[pos] - '0') * 10 + (text[pos + 1] - '0');
+}
+
+// "HH:MM" -> minutes from midnight
+int parse_clock(const std::string& text) {
+    int hours = two_digits(text, 0);
+    int minutes = two_digits(text, 3);
+    if (text.size() != 5 || text[2] != ':' || hours < 0 || hours > 23 || minutes < 0 || minutes > 59) {
+        throw std::invalid_argument("Invalid session time (expected HH:MM): " + text);
+    }
+    return hours * 60 + minutes;
+}
+
+int parse_day(const std::string& text) {
+    for (int d = 0; d < 7; ++d) {
+        if (text == kDayNames[d]) return d;
+    }
+    throw std::invalid_argument("Invalid session weekday: " + text);
+}
+
+// Minutes from midnight of "YYYY-MM-DD HH:MM...", or -1 for date-only rows
+int minute_of_day(std::string_view date) {
+    if (date.size() < 16 || date[13] != ':') return -1;
+    int hours = two_digits(date, 11);
+    int minutes = two_digits(date, 14);
+    return (hours < 0 || minutes < 0) ? -1 : hours * 60 + minutes;
+}
+
+// 0 = Sunday, -1 if date does not start with YYYY-MM-DD
+int weekday_of(std::string_view date) {
+    int64_t days;
+    return TimeUtils::parse_date(date, days) ? TimeUtils::weekday_from_days(days) : -1;
+}
+
+bool day_is_active(const SessionSpec& spec, std::string_view date) {
+    if (spec.weekday_mask != 0x7F) {
+        int weekday = weekday_of(date);
+        if (weekday >= 0 && !(spec.weekday_mask & (1u << weekday))) return false;
+    }
+    if (!spec.holidays.empty() && date.size() >= 10) {
+        std::string_view day = date.substr(0, 10);
+        for (const auto& holiday : spec.holidays) {
+            if (day == holiday) return false;
+        }
+    }
+    return true;
+}
+
+bool time_is_active(const SessionSpec& spec, std::string_view date) {
+    if (spec.windows.empty()) return true;
+    int minute = minute_of_day(date);
+    if (minute < 0) return true;  // Daily bars carry no time of day
+    for (const auto& window : spec.windows) {
+        if (window.contains(minute)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+SessionSpec SessionSpec::parse(const std::string& text) {
+    SessionSpec spec;
+    std::string normalized = text;
+    std::replace(normalized.begin(), normalized.end(), ',', ' ');
+    std::istringstream tokens(normalized);
+    std::string token;
+    bool have_days = false;
+    while (tokens >> token) {
+        std::transform(token.begin(), token.end(), token.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        auto dash = token.find('-');
+        if (std::isalpha(static_cast<unsigned char>(token[0]))) {
+            // "mon-fri" or a single day
+            if (!have_days) spec.weekday_mask = 0;
+            have_days = true;
+            int first = parse_day(token.substr(0, dash));
+            int last = (dash == std::string::npos) ? first : parse_day(token.substr(dash + 1));
+            for (int d = first;; d = (d + 1) % 7) {
+                spec.weekday_mask |= static_cast<uint8_t>(1u << d);
+                if (d == last) break;
+            }
+        } else {
+            if (dash == std::string::npos) throw std::invalid_argument("Invalid session window: " + token);
+            TimeWindow window{parse_clock(token.substr(0, dash)), parse_clock(token.substr(dash + 1))};
+            if (window.end_minute < window.start_minute) {
+                throw std::invalid_argument("Session window ends before it starts: " + token);
+            }
+            spec.windows.push_back(window);
+        }
+    }
+    return spec;
+}
+
+bool SessionSpec::is_active(std::string_view date) const {
+    return day_is_active(*this, date) && time_is_active(*this, date);
+}
+
+std::string SessionSpec::key() const {
+    std::ostringstream out;
+    out << static_cast<int>(weekday_mask) << '|' << warmup_ticks << '|';
+    for (const auto& window : windows) out << window.start_minute << '-' << window.end_minute << ',';
+    out << '|';
+    for (const auto& holiday : holidays) out << holiday << ',';
+    return out.str();
+}
+
+namespace SessionFilter {
+
+std::vector<TickRange> build_ranges(const TickDataStore::TickData& ticks, const SessionSpec& spec) {
+    const size_t rows = ticks.size();
+    if (spec.is_unrestricted()) return rows > 0 ? std::vector<TickRange>{{0, rows, false}} : std::vector<TickRange>{};
+
+    std::vector<TickRange> active;
+    std::string_view current_day;
+    bool day_active = true;
+    for (size_t i = 0; i < rows; ++i) {
+        std::string_view date = ticks.date[i];
+        // Day checks run once per calendar day, not per tick
+        std::string_view day = date.substr(0, std::min<size_t>(10, date.size()));
+        if (day != current_day) {
+            current_day = day;
+            day_active = day_is_active(spec, date);
+        }
+        if (!day_active || !time_is_active(spec, date)) continue;
+        if (!active.empty() && active.back().end == i) {
+            ++active.back().end;
+        } else {
+            active.push_back({i, i + 1, false});
+        }
+    }
+    if (spec.warmup_ticks == 0) return active;
+
+    std::vector<TickRange> ranges;
+    size_t previous_end = 0;
+    for (const auto& range : active) {
+        size_t warmup_begin = range.begin > spec.warmup_ticks ? range.begin - spec.warmup_ticks : 0;
+        warmup_begin = std::max(warmup_begin, previous_end);
+        if (warmup_begin < range.begin) ranges.push_back({warmup_begin, range.begin, true});
+        ranges.push_back(range);
+        previous_end = range.end;
+    }
+    return ranges;
+}
+
+std::vector<TickRange> merge(const std::vector<const std::vector<TickRange>*>& lists) {
+    std::vector<TickRange> all;
+    for (const auto* list : lists) all.insert(all.end(), list->begin(), list->end());
+    std::sort(all.begin(), all.end(), [](const TickRange& a, const TickRange& b) { return a.begin < b.begin; });
+    std::vector<TickRange> merged;
+    for (const auto& range : all) {
+        if (!merged.empty() && range.begin <= merged.back().end) {
+            merged.back().end = std::max(merged.back().end, range.end);
+            merged.back().warmup = merged.back().warmup && range.warmup;
+        } else {
+            merged.push_back(range);
+        }
+    }
+    return merged;
+}
+
+} // namespace SessionFilter
+
+} // namespace backtest
@@ -0,0 +1,265 @@
+#include "data/shared_tick_cache.h"
+#include "data/tick_snapshot.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+    #include <cerrno>
+    #include <csignal>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace backtest {
+namespace SharedTickCache {
+
+#ifdef _WIN32
+
+bool attach(const std::string&, uint64_t, TickDataStore&) {
+    return false;
+}
+
+void attach_or_publish(const std::string&, uint64_t, const std::function<void(TickDataStore&)>& loader,
+                       TickDataStore& store) {
+    loader(store);  // No POSIX shm: every process keeps its own copy
+}
+
+int32_t reference_count(const std::string&) {
+    return -1;
+}
+
+void remove(const std::string&) {}
+
+#else
+
+namespace {
+
+enum State : uint32_t {
+    LOADING = 0,
+    READY = 1,
+    FAILED = 2
+};
+
+// Lives at offset 0 of the segment; only lock-free atomics so it is
+// valid across processes
+struct ControlBlock {
+    char magic[8];
+    std::atomic<uint32_t> state;
+    std::atomic<int32_t> refcount;
+    uint64_t image_offset;
+    uint64_t image_bytes;
+    std::atomic<int32_t> publisher_pid;  // Checked by attachers while LOADING
+    uint32_t reserved;
+    uint64_t fingerprint;  // Of the publisher's data sources
+};
+
+// A segment still without a publisher pid this long after it was sized
+// belongs to a publisher that died in between
+constexpr auto kPublisherPidWait = std::chrono::seconds(10);
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<int32_t>::is_always_lock_free,
+              "Shared control block needs lock-free atomics");
+
+constexpr size_t kImageOffset = (sizeof(ControlBlock) + TickSnapshot::kAlignment - 1) &
+                                ~(TickSnapshot::kAlignment - 1);
+
+// shm names must be a single leading-slash component
+std::string shm_name(const std::string& name) {
+    if (name.empty() || name.find('/') != std::string::npos) {
+        throw std::invalid_argument("Invalid shared cache name: " + name);
+    }
+    return "/" + name;
+}
+
+// Drop one reference; the last holder unlinks the name
+void release(const std::string& shm, ControlBlock* control, size_t size) {
+    if (control->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        ::shm_unlink(shm.c_str());
+    }
+    ::munmap(control, size);
+}
+
+// Unlink shm if the name still refers to the segment described by opened
+// (and not to one republished under the same name meanwhile)
+void unlink_if_same(const std::string& shm, const struct stat& opened) {
+    int fd = ::shm_open(shm.c_str(), O_RDONLY, 0);
+    if (fd < 0) return;
+    struct stat now{};
+    const bool same = ::fstat(fd, &now) == 0 && now.st_dev == opened.st_dev && now.st_ino == opened.st_ino;
+    ::close(fd);
+    if (same) ::shm_unlink(shm.c_str());
+}
+
+// False once the process that is publishing a segment is known to be gone.
+// Publisher and attachers must share a pid namespace, as they share /dev/shm.
+bool publisher_alive(const ControlBlock& control, std::chrono::steady_clock::time_point waiting_since) {
+    const int32_t pid = control.publisher_pid.load(std::memory_order_acquire);
+    if (pid <= 0) return std::chrono::steady_clock::now() - waiting_since < kPublisherPidWait;
+    return ::kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// Wait for the publisher, then take a reference. Returns 0 on success,
+// ENOENT if the segment is gone (or was torn down while we looked, or its
+// publisher died before finishing, in which case it is unlinked here).
+// Throws if the segment was published from other data sources.
+int try_attach(const std::string& shm, uint64_t fingerprint, TickDataStore& store) {
+    int fd = ::shm_open(shm.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        if (errno == ENOENT) return ENOENT;
+        throw std::runtime_error("shm_open " + shm + ": " + std::strerror(errno));
+    }
+
+    // The publisher sizes the segment after creating it
+    struct stat st{};
+    for (int i = 0; i < 1000 && ::fstat(fd, &st) == 0 && st.st_size == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (st.st_size < static_cast<off_t>(kImageOffset)) {
+        ::close(fd);
+        throw std::runtime_error("Shared cache " + shm + " was never initialized");
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) throw std::runtime_error("mmap " + shm + ": " + std::strerror(errno));
+    auto* control = static_cast<ControlBlock*>(addr);
+
+    const auto waiting_since = std::chrono::steady_clock::now();
+    while (control->state.load(std::memory_order_acquire) == LOADING) {
+        if (!publisher_alive(*control, waiting_since)) {
+            ::munmap(addr, size);
+            unlink_if_same(shm, st);
+            return ENOENT;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    if (control->state.load(std::memory_order_acquire) != READY ||
+        std::memcmp(control->magic, kMagic, sizeof(kMagic)) != 0) {
+        ::munmap(addr, size);
+        throw std::runtime_error("Shared cache " + shm + " is not a published tick cache");
+    }
+    if (control->fingerprint != fingerprint) {
+        ::munmap(addr, size);
+        throw std::runtime_error("Shared cache " + shm.substr(1) + " holds other data than configured (sources "
+                                 "changed, or a crashed run left it behind); clear it with "
+                                 "nemo --remove-shared-cache " + shm.substr(1));
+    }
+
+    // Only join a live segment; zero means the last holder is unlinking it
+    int32_t refs = control->refcount.load(std::memory_order_acquire);
+    do {
+        if (refs <= 0) {
+            ::munmap(addr, size);
+            return ENOENT;
+        }
+    } while (!control->refcount.compare_exchange_weak(refs, refs + 1, std::memory_order_acq_rel));
+
+    TickSnapshot::attach(static_cast<const char*>(addr) + control->image_offset,
+                         control->image_bytes, store);
+    store.retain_backing(std::shared_ptr<const void>(addr, [shm, size](const void* p) {
+        release(shm, static_cast<ControlBlock*>(const_cast<void*>(p)), size);
+    }));
+    return 0;
+}
+
+// Create and fill the segment. Returns false if another process got there first.
+bool try_publish(const std::string& shm, uint64_t fingerprint, const TickDataStore& source, TickDataStore& store) {
+    int fd = ::shm_open(shm.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        if (errno == EEXIST) return false;
+        throw std::runtime_error("shm_open " + shm + ": " + std::strerror(errno));
+    }
+
+    const size_t image_bytes = TickSnapshot::encoded_size(source);
+    const size_t size = kImageOffset + image_bytes;
+    void* addr = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::string error = std::strerror(errno);
+        ::shm_unlink(shm.c_str());
+        throw std::runtime_error("Could not size shared cache " + shm + ": " + error);
+    }
+
+    // ftruncate zero-fills, so state already reads LOADING to attachers
+    auto* control = new (addr) ControlBlock{};
+    std::memcpy(control->magic, kMagic, sizeof(kMagic));
+    control->image_offset = kImageOffset;
+    control->image_bytes = image_bytes;
+    control->fingerprint = fingerprint;
+    control->refcount.store(1, std::memory_order_relaxed);
+    control->publisher_pid.store(static_cast<int32_t>(::getpid()), std::memory_order_release);
+    try {
+        TickSnapshot::encode(source, static_cast<char*>(addr) + kImageOffset, image_bytes);
+        TickSnapshot::attach(static_cast<const char*>(addr) + kImageOffset, image_bytes, store);
+    } catch (...) {
+        control->state.store(FAILED, std::memory_order_release);
+        ::shm_unlink(shm.c_str());
+        ::munmap(addr, size);
+        throw;
+    }
+    control->state.store(READY, std::memory_order_release);
+
+    store.retain_backing(std::shared_ptr<const void>(addr, [shm, size](const void* p) {
+        release(shm, static_cast<ControlBlock*>(const_cast<void*>(p)), size);
+    }));
+    return true;
+}
+
+} // namespace
+
+bool attach(const std::string& name, uint64_t fingerprint, TickDataStore& store) {
+    return try_attach(shm_name(name), fingerprint, store) == 0;
+}
+
+void attach_or_publish(const std::string& name, uint64_t fingerprint,
+                       const std::function<void(TickDataStore&)>& loader, TickDataStore& store) {
+    const std::string shm = shm_name(name);
+    TickDataStore source;
+    bool loaded = false;
+    // Loop covers losing the create race and segments torn down mid-attach
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        if (try_attach(shm, fingerprint, store) == 0) return;
+        if (!loaded) {
+            loader(source);
+            loaded = true;
+        }
+        if (try_publish(shm, fingerprint, source, store)) return;
+    }
+    throw std::runtime_error("Could not attach or publish shared cache " + name);
+}
+
+int32_t reference_count(const std::string& name) {
+    const std::string shm = shm_name(name);
+    int fd = ::shm_open(shm.c_str(), O_RDONLY, 0);
+    if (fd < 0) return -1;
+    struct stat st{};
+    int32_t refs = -1;
+    if (::fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(kImageOffset)) {
+        void* addr = ::mmap(nullptr, sizeof(ControlBlock), PROT_READ, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            refs = static_cast<const ControlBlock*>(addr)->refcount.load(std::memory_order_acquire);
+            ::munmap(addr, sizeof(ControlBlock));
+        }
+    }
+    ::close(fd);
+    return refs;
+}
+
+void remove(const std::string& name) {
+    ::shm_unlink(shm_name(name).c_str());
+}
+
+#endif
+
+} // namespace SharedTickCache
+} // namespace backtest
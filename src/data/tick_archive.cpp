@@ -0,0 +1,348 @@
+#include "data/tick_archive.h"
+#include "utils/binary_io.h"
+#include "utils/logging.h"
+#include "utils/time_utils.h"
+#include "utils/trace.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+namespace backtest {
+namespace TickArchive {
+
+namespace fs = std::filesystem;
+using TickData = TickDataStore::TickData;
+using namespace TickSnapshot;
+
+namespace {
+
+int64_t day_of(int64_t epoch_ns) {
+    return epoch_ns >= 0 ? epoch_ns / TimeUtils::kNanosPerDay
+                         : -((-(epoch_ns + 1)) / TimeUtils::kNanosPerDay) - 1;
+}
+
+int64_t ns_at(const TickData& ticks, size_t row) {
+    return TimeUtils::to_epoch_ns(ticks.timestamps[row]);
+}
+
+void check_name(const InstrumentId& instrument) {
+    if (instrument.empty() || instrument == "." || instrument == ".." ||
+        instrument.find_first_of("/\\") != std::string::npos) {
+        throw std::invalid_argument("Instrument name cannot be an archive directory: " + instrument);
+    }
+}
+
+// First element and width of a fixed-width column
+std::pair<const char*, size_t> fixed_column(const TickData& ticks, uint32_t column) {
+    auto bytes = [](const auto& col) {
+        return std::pair<const char*, size_t>(reinterpret_cast<const char*>(col.data()), sizeof(*col.data()));
+    };
+    switch (column) {
+        case TIMESTAMPS: return bytes(ticks.timestamps);
+        case BID_PRICES: return bytes(ticks.bid_prices);
+        case ASK_PRICES: return bytes(ticks.ask_prices);
+        case BID_SIZES: return bytes(ticks.bid_sizes);
+        case ASK_SIZES: return bytes(ticks.ask_sizes);
+        case LAST_PRICES: return bytes(ticks.last_prices);
+        case VOLUMES: return bytes(ticks.volumes);
+        case OPEN: return bytes(ticks.open);
+        case HIGH: return bytes(ticks.high);
+        case LOW: return bytes(ticks.low);
+        default: return bytes(ticks.close);
+    }
+}
+
+double value_at(const TickData& ticks, uint32_t column, size_t row) {
+    switch (column) {
+        case BID_SIZES: return static_cast<double>(ticks.bid_sizes[row]);
+        case ASK_SIZES: return static_cast<double>(ticks.ask_sizes[row]);
+        case VOLUMES: return static_cast<double>(ticks.volumes[row]);
+        default: {
+            double value;
+            std::memcpy(&value, fixed_column(ticks, column).first + row * sizeof(double), sizeof(value));
+            return value;
+        }
+    }
+}
+
+size_t block_bytes(uint64_t rows, uint64_t date_chars) {
+    return static_cast<size_t>(rows * sizeof(int64_t) * DATE_OFFSETS + (rows + 1) * sizeof(uint64_t) + date_chars);
+}
+
+void pad(BinaryWriter& out) {
+    static const char zeros[8] = {};
+    const size_t size = out.buffer().size();
+    if (size % 8) out.raw(zeros, 8 - size % 8);
+}
+
+void merge(ColumnRange& into, const ColumnRange& range, bool first) {
+    into.min = first ? range.min : std::min(into.min, range.min);
+    into.max = first ? range.max : std::max(into.max, range.max);
+}
+
+// One day of one instrument, rows already in time order
+std::vector<char> encode_partition(const TickData& ticks, size_t block_rows) {
+    BinaryWriter out;
+    std::vector<BlockInfo> blocks;
+    for (size_t begin = 0; begin < ticks.size(); begin += block_rows) {
+        const size_t end = std::min(begin + block_rows, ticks.size());
+        const size_t rows = end - begin;
+        pad(out);
+        BlockInfo info{};
+        info.offset = out.buffer().size();
+        info.rows = rows;
+        info.first_ns = ns_at(ticks, begin);
+        info.last_ns = ns_at(ticks, end - 1);
+        for (uint32_t c = TIMESTAMPS; c < DATE_OFFSETS; ++c) {
+            auto [data, width] = fixed_column(ticks, c);
+            out.raw(data + begin * width, rows * width);
+        }
+        const auto& offsets = ticks.date.offsets();
+        for (size_t i = begin; i <= end; ++i) out.pod(offsets[i] - offsets[begin]);
+        info.date_chars = offsets[end] - offsets[begin];
+        out.raw(ticks.date.chars().data() + offsets[begin], info.date_chars);
+        info.bytes = out.buffer().size() - info.offset;
+        for (uint32_t v = 0; v < kValueColumns; ++v) {
+            const uint32_t column = kFirstValueColumn + v;
+            info.ranges[v] = {value_at(ticks, column, begin), value_at(ticks, column, begin)};
+            for (size_t i = begin + 1; i < end; ++i) {
+                const double value = value_at(ticks, column, i);
+                info.ranges[v].min = std::min(info.ranges[v].min, value);
+                info.ranges[v].max = std::max(info.ranges[v].max, value);
+            }
+        }
+        blocks.push_back(info);
+    }
+
+    PartitionFooter footer{};
+    footer.rows = ticks.size();
+    footer.block_count = static_cast<uint32_t>(blocks.size());
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        footer.first_ns = b ? std::min(footer.first_ns, blocks[b].first_ns) : blocks[b].first_ns;
+        footer.last_ns = b ? std::max(footer.last_ns, blocks[b].last_ns) : blocks[b].last_ns;
+        for (uint32_t v = 0; v < kValueColumns; ++v) merge(footer.ranges[v], blocks[b].ranges[v], b == 0);
+    }
+    pad(out);
+    Trailer trailer{};
+    trailer.footer_offset = out.buffer().size();
+    trailer.version = kVersion;
+    std::memcpy(trailer.magic, kMagic, sizeof(kMagic));
+    out.pod(footer);
+    out.raw(blocks.data(), blocks.size() * sizeof(BlockInfo));
+    out.pod(trailer);
+    return out.buffer();
+}
+
+[[noreturn]] void corrupt(const std::string& path) {
+    throw std::runtime_error("Archive partition " + path + " is truncated or corrupt");
+}
+
+// Footer and block table through an open stream; returns the bytes read
+size_t read_footer(std::ifstream& file, const std::string& path, PartitionFooter& footer,
+                   std::vector<BlockInfo>& blocks) {
+    file.seekg(0, std::ios::end);
+    const auto size = static_cast<uint64_t>(file.tellg());
+    if (size < sizeof(Trailer) + sizeof(PartitionFooter)) corrupt(path);
+    Trailer trailer;
+    file.seekg(static_cast<std::streamoff>(size - sizeof(Trailer)));
+    if (!file.read(reinterpret_cast<char*>(&trailer), sizeof(trailer)) ||
+        std::memcmp(trailer.magic, kMagic, sizeof(kMagic)) != 0) {
+        corrupt(path);
+    }
+    if (trailer.version != kVersion) throw std::runtime_error("Unsupported archive partition version: " + path);
+    if (trailer.footer_offset > size - sizeof(Trailer) - sizeof(PartitionFooter)) corrupt(path);
+    file.seekg(static_cast<std::streamoff>(trailer.footer_offset));
+    if (!file.read(reinterpret_cast<char*>(&footer), sizeof(footer))) corrupt(path);
+    if (footer.block_count != (size - sizeof(Trailer) - trailer.footer_offset - sizeof(footer)) / sizeof(BlockInfo)) {
+        corrupt(path);
+    }
+    blocks.resize(footer.block_count);
+    if (!file.read(reinterpret_cast<char*>(blocks.data()),
+                   static_cast<std::streamsize>(blocks.size() * sizeof(BlockInfo)))) {
+        corrupt(path);
+    }
+    for (const auto& block : blocks) {
+        if (block.offset % 8 || block.offset + block.bytes > trailer.footer_offset ||
+            block.bytes != block_bytes(block.rows, block.date_chars)) {
+            corrupt(path);
+        }
+    }
+    return static_cast<size_t>(size - trailer.footer_offset);
+}
+
+// Columns of one block viewed in place; data must be 8-byte aligned
+void attach_block(const char* data, const BlockInfo& block, TickData& view) {
+    const size_t rows = static_cast<size_t>(block.rows);
+    size_t offset = 0;
+    auto next = [&](size_t bytes) {
+        const char* p = data + offset;
+        offset += bytes;
+        return p;
+    };
+    view.timestamps.attach(reinterpret_cast<const Timestamp*>(next(rows * sizeof(Timestamp))), rows);
+    view.bid_prices.attach(reinterpret_cast<const Price*>(next(rows * sizeof(Price))), rows);
+    view.ask_prices.attach(reinterpret_cast<const Price*>(next(rows * sizeof(Price))), rows);
+    view.bid_sizes.attach(reinterpret_cast<const Volume*>(next(rows * sizeof(Volume))), rows);
+    view.ask_sizes.attach(reinterpret_cast<const Volume*>(next(rows * sizeof(Volume))), rows);
+    view.last_prices.attach(reinterpret_cast<const Price*>(next(rows * sizeof(Price))), rows);
+    view.volumes.attach(reinterpret_cast<const Volume*>(next(rows * sizeof(Volume))), rows);
+    view.open.attach(reinterpret_cast<const double*>(next(rows * sizeof(double))), rows);
+    view.high.attach(reinterpret_cast<const double*>(next(rows * sizeof(double))), rows);
+    view.low.attach(reinterpret_cast<const double*>(next(rows * sizeof(double))), rows);
+    view.close.attach(reinterpret_cast<const double*>(next(rows * sizeof(double))), rows);
+    const auto* offsets = reinterpret_cast<const uint64_t*>(next((rows + 1) * sizeof(uint64_t)));
+    view.date.attach(offsets, rows, next(static_cast<size_t>(block.date_chars)), static_cast<size_t>(block.date_chars));
+}
+
+void read_partition(const std::string& path, const Query& query, TickData& dest, ScanStats& stats) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open archive partition: " + path);
+    PartitionFooter footer;
+    std::vector<BlockInfo> blocks;
+    stats.bytes_read += read_footer(file, path, footer, blocks);
+    ++stats.partitions_read;
+    if (footer.rows == 0 || footer.last_ns < query.from_ns || footer.first_ns > query.to_ns) {
+        ++stats.partitions_skipped;
+        stats.blocks_skipped += blocks.size();
+        return;
+    }
+    const Timestamp from = TimeUtils::from_epoch_ns(query.from_ns);
+    const Timestamp to = TimeUtils::from_epoch_ns(query.to_ns);
+    std::vector<uint64_t> buffer;  // 8-byte aligned for the column views
+    for (const auto& block : blocks) {
+        if (block.last_ns < query.from_ns || block.first_ns > query.to_ns) {
+            ++stats.blocks_skipped;
+            continue;
+        }
+        buffer.resize((block.bytes + 7) / 8);
+        file.seekg(static_cast<std::streamoff>(block.offset));
+        if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(block.bytes))) corrupt(path);
+        TickData view;
+        attach_block(reinterpret_cast<const char*>(buffer.data()), block, view);
+        const size_t lo = static_cast<size_t>(std::lower_bound(view.timestamps.begin(), view.timestamps.end(), from) -
+                                              view.timestamps.begin());
+        const size_t hi = static_cast<size_t>(std::upper_bound(view.timestamps.begin(), view.timestamps.end(), to) -
+                                              view.timestamps.begin());
+        if (lo < hi) dest.append_rows(view, lo, hi);
+        ++stats.blocks_read;
+        stats.rows += hi > lo ? hi - lo : 0;
+        stats.bytes_read += static_cast<size_t>(block.bytes);
+    }
+}
+
+// Numeric directory or file names in [low, high], in order
+std::vector<std::pair<int64_t, fs::path>> entries_between(const fs::path& dir, int64_t low, int64_t high, bool days) {
+    std::vector<std::pair<int64_t, fs::path>> found;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        const std::string name = entry.path().filename().string();
+        int64_t key = 0;
+        if (days) {
+            if (!name.ends_with(".part") || name.size() != 15 || !TimeUtils::parse_date(name, key)) continue;
+        } else {
+            if (name.empty() || name.size() > 5 || name.find_first_not_of("0123456789") != std::string::npos) continue;
+            key = std::stoll(name);
+        }
+        if (key >= low && key <= high) found.emplace_back(key, entry.path());
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+int64_t year_of(int64_t day) {
+    return std::stoll(TimeUtils::format_date(day).substr(0, 4));
+}
+
+} // namespace
+
+std::string partition_path(const std::string& root, const InstrumentId& instrument, int64_t day) {
+    const std::string date = TimeUtils::format_date(day);
+    return (fs::path(root) / instrument / date.substr(0, 4) / (date + ".part")).string();
+}
+
+size_t write(const TickDataStore& store, const std::string& root, size_t block_rows) {
+    TraceSpan span("write_archive");
+    block_rows = std::max<size_t>(block_rows, 1);
+    size_t written = 0;
+    for (const auto& instrument : store.get_instruments()) {
+        check_name(instrument);
+        const auto& ticks = *store.get_ticks(instrument);
+        std::vector<size_t> order(ticks.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&ticks](size_t a, size_t b) { return ticks.timestamps[a] < ticks.timestamps[b]; });
+        for (size_t first = 0; first < order.size();) {
+            const int64_t day = day_of(ns_at(ticks, order[first]));
+            size_t last = first;
+            while (last < order.size() && day_of(ns_at(ticks, order[last])) == day) ++last;
+            // Rows of the day in time order, copied a run of consecutive rows at a time
+            TickData part;
+            part.reserve(last - first);
+            for (size_t i = first; i < last;) {
+                size_t end = i + 1;
+                while (end < last && order[end] == order[end - 1] + 1) ++end;
+                part.append_rows(ticks, order[i], order[end - 1] + 1);
+                i = end;
+            }
+            const std::string path = partition_path(root, instrument, day);
+            fs::create_directories(fs::path(path).parent_path());
+            replace_binary_file(path, encode_partition(part, block_rows));
+            ++written;
+            first = last;
+        }
+    }
+    return written;
+}
+
+ScanStats load(const std::string& root, const Query& query, TickDataStore& store) {
+    TraceSpan span("load_archive");
+    ScanStats stats;
+    if (!fs::is_directory(root)) throw std::runtime_error("Not a tick archive directory: " + root);
+    if (query.from_ns > query.to_ns) return stats;
+
+    std::vector<InstrumentId> instruments = query.instruments;
+    if (instruments.empty()) {
+        for (const auto& entry : fs::directory_iterator(root)) {
+            if (entry.is_directory()) instruments.push_back(entry.path().filename().string());
+        }
+        std::sort(instruments.begin(), instruments.end());
+    }
+    const bool from_open = query.from_ns == std::numeric_limits<int64_t>::min();
+    const bool to_open = query.to_ns == std::numeric_limits<int64_t>::max();
+    const int64_t first_day = from_open ? std::numeric_limits<int64_t>::min() : day_of(query.from_ns);
+    const int64_t last_day = to_open ? std::numeric_limits<int64_t>::max() : day_of(query.to_ns);
+    const int64_t first_year = from_open ? 0 : year_of(first_day);
+    const int64_t last_year = to_open ? 99999 : year_of(last_day);
+
+    for (const auto& instrument : instruments) {
+        check_name(instrument);
+        const fs::path dir = fs::path(root) / instrument;
+        if (!fs::is_directory(dir)) {
+            Logger::get().warn("TickArchive", "No partitions for " + instrument + " in " + root);
+            continue;
+        }
+        auto& dest = store.get_or_create(instrument);
+        for (const auto& [year, year_dir] : entries_between(dir, first_year, last_year, false)) {
+            for (const auto& [day, path] : entries_between(year_dir, first_day, last_day, true)) {
+                read_partition(path.string(), query, dest, stats);
+            }
+        }
+    }
+    return stats;
+}
+
+PartitionFooter read_footer(const std::string& path, std::vector<BlockInfo>* blocks) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open archive partition: " + path);
+    PartitionFooter footer;
+    std::vector<BlockInfo> table;
+    read_footer(file, path, footer, table);
+    if (blocks) *blocks = std::move(table);
+    return footer;
+}
+
+} // namespace TickArchive
+} // namespace backtest
@@ -0,0 +1,206 @@
+#include "data/tick_snapshot.h"
+#include "utils/trace.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace backtest {
+namespace TickSnapshot {
+
+static_assert(sizeof(Timestamp) == sizeof(int64_t) && std::is_trivially_copyable_v<Timestamp>,
+              "Timestamp must be a plain 64-bit value to be stored in snapshots");
+
+namespace {
+
+size_t align_up(size_t value) {
+    return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+// Sorted instrument order keeps images byte-identical across runs
+std::vector<std::pair<InstrumentId, const TickDataStore::TickData*>> sorted_instruments(
+        const TickDataStore& store) {
+    std::vector<std::pair<InstrumentId, const TickDataStore::TickData*>> result;
+    for (const auto& instrument : store.get_instruments()) {
+        result.emplace_back(instrument, store.get_ticks(instrument));
+    }
+    std::sort(result.begin(), result.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    return result;
+}
+
+size_t column_bytes(const TickDataStore::TickData& ticks, uint32_t column) {
+    const size_t rows = ticks.size();
+    switch (column) {
+        case TIMESTAMPS: return rows * sizeof(Timestamp);
+        case BID_SIZES: case ASK_SIZES: case VOLUMES: return rows * sizeof(Volume);
+        case DATE_OFFSETS: return (rows + 1) * sizeof(uint64_t);
+        case DATE_CHARS: return ticks.date.chars().size();
+        default: return rows * sizeof(double);
+    }
+}
+
+const void* column_data(const TickDataStore::TickData& ticks, uint32_t column) {
+    switch (column) {
+        case TIMESTAMPS: return ticks.timestamps.data();
+        case BID_PRICES: return ticks.bid_prices.data();
+        case ASK_PRICES: return ticks.ask_prices.data();
+        case BID_SIZES: return ticks.bid_sizes.data();
+        case ASK_SIZES: return ticks.ask_sizes.data();
+        case LAST_PRICES: return ticks.last_prices.data();
+        case VOLUMES: return ticks.volumes.data();
+        case OPEN: return ticks.open.data();
+        case HIGH: return ticks.high.data();
+        case LOW: return ticks.low.data();
+        case CLOSE: return ticks.close.data();
+        case DATE_OFFSETS: return ticks.date.offsets().data();
+        default: return ticks.date.chars().data();
+    }
+}
+
+// Compute the entry table and total size in one pass
+size_t layout(const std::vector<std::pair<InstrumentId, const TickDataStore::TickData*>>& instruments,
+              std::vector<InstrumentEntry>& entries) {
+    size_t offset = sizeof(Header) + instruments.size() * sizeof(InstrumentEntry);
+    entries.assign(instruments.size(), InstrumentEntry{});
+    for (size_t i = 0; i < instruments.size(); ++i) {
+        entries[i].name_offset = offset;
+        entries[i].name_length = static_cast<uint32_t>(instruments[i].first.size());
+        offset += instruments[i].first.size();
+    }
+    for (size_t i = 0; i < instruments.size(); ++i) {
+        const auto& ticks = *instruments[i].second;
+        entries[i].rows = ticks.size();
+        entries[i].date_chars = ticks.date.chars().size();
+        for (uint32_t c = 0; c < COLUMN_COUNT; ++c) {
+            offset = align_up(offset);
+            entries[i].column_offsets[c] = offset;
+            offset += column_bytes(ticks, c);
+        }
+    }
+    return align_up(offset);
+}
+
+} // namespace
+
+size_t encoded_size(const TickDataStore& store) {
+    std::vector<InstrumentEntry> entries;
+    return layout(sorted_instruments(store), entries);
+}
+
+void encode(const TickDataStore& store, char* dest, size_t size) {
+    auto instruments = sorted_instruments(store);
+    std::vector<InstrumentEntry> entries;
+    const size_t total = layout(instruments, entries);
+    if (size < total) throw std::invalid_argument("Snapshot buffer too small");
+
+    std::memset(dest, 0, total);
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.instrument_count = static_cast<uint32_t>(instruments.size());
+    header.total_bytes = total;
+    std::memcpy(dest, &header, sizeof(header));
+    std::memcpy(dest + sizeof(Header), entries.data(), entries.size() * sizeof(InstrumentEntry));
+
+    for (size_t i = 0; i < instruments.size(); ++i) {
+        const auto& [name, ticks] = instruments[i];
+        std::memcpy(dest + entries[i].name_offset, name.data(), name.size());
+        for (uint32_t c = 0; c < COLUMN_COUNT; ++c) {
+            size_t bytes = column_bytes(*ticks, c);
+            if (bytes > 0) std::memcpy(dest + entries[i].column_offsets[c], column_data(*ticks, c), bytes);
+        }
+    }
+}
+
+void attach(const char* image, size_t size, TickDataStore& store) {
+    Header header;
+    if (size < sizeof(Header)) throw std::runtime_error("Snapshot image is truncated");
+    std::memcpy(&header, image, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a tick snapshot image");
+    }
+    if (header.version != kVersion) throw std::runtime_error("Unsupported tick snapshot version");
+    if (header.total_bytes > size) throw std::runtime_error("Snapshot image is truncated");
+
+    const auto* entries = reinterpret_cast<const InstrumentEntry*>(image + sizeof(Header));
+    for (uint32_t i = 0; i < header.instrument_count; ++i) {
+        const auto& entry = entries[i];
+        InstrumentId name(image + entry.name_offset, entry.name_length);
+        auto& ticks = store.get_or_create(name);
+        auto at = [&](uint32_t column) { return image + entry.column_offsets[column]; };
+        ticks.timestamps.attach(reinterpret_cast<const Timestamp*>(at(TIMESTAMPS)), entry.rows);
+        ticks.bid_prices.attach(reinterpret_cast<const Price*>(at(BID_PRICES)), entry.rows);
+        ticks.ask_prices.attach(reinterpret_cast<const Price*>(at(ASK_PRICES)), entry.rows);
+        ticks.bid_sizes.attach(reinterpret_cast<const Volume*>(at(BID_SIZES)), entry.rows);
+        ticks.ask_sizes.attach(reinterpret_cast<const Volume*>(at(ASK_SIZES)), entry.rows);
+        ticks.last_prices.attach(reinterpret_cast<const Price*>(at(LAST_PRICES)), entry.rows);
+        ticks.volumes.attach(reinterpret_cast<const Volume*>(at(VOLUMES)), entry.rows);
+        ticks.open.attach(reinterpret_cast<const double*>(at(OPEN)), entry.rows);
+        ticks.high.attach(reinterpret_cast<const double*>(at(HIGH)), entry.rows);
+        ticks.low.attach(reinterpret_cast<const double*>(at(LOW)), entry.rows);
+        ticks.close.attach(reinterpret_cast<const double*>(at(CLOSE)), entry.rows);
+        ticks.date.attach(reinterpret_cast<const uint64_t*>(at(DATE_OFFSETS)), entry.rows,
+                          at(DATE_CHARS), entry.date_chars);
+    }
+}
+
+void write_file(const TickDataStore& store, const std::string& path) {
+    TraceSpan span("write_snapshot");
+    std::vector<char> image(encoded_size(store));
+    encode(store, image.data(), image.size());
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) throw std::runtime_error("Could not write tick snapshot: " + path);
+    file.write(image.data(), static_cast<std::streamsize>(image.size()));
+}
+
+void map_file(const std::string& path, TickDataStore& store) {
+#ifdef _WIN32
+    // No mmap: read into one heap buffer that still backs the column views
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open tick snapshot: " + path);
+    auto image = std::make_shared<std::vector<char>>((std::istreambuf_iterator<char>(file)),
+                                                     std::istreambuf_iterator<char>());
+    attach(image->data(), image->size(), store);
+    store.retain_backing(image);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Could not open tick snapshot: " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not stat tick snapshot: " + path);
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) throw std::runtime_error("Could not map tick snapshot: " + path);
+
+    std::shared_ptr<const void> mapping(addr, [size](const void* p) {
+        ::munmap(const_cast<void*>(p), size);
+    });
+    attach(static_cast<const char*>(addr), size, store);
+    store.retain_backing(std::move(mapping));
+#endif
+}
+
+void place(TickDataStore& store, const MemoryPlacement& placement) {
+    const size_t size = encoded_size(store);
+    std::shared_ptr<char> image = allocate_placed(size, placement);
+    encode(store, image.get(), size);
+    TickDataStore placed;
+    attach(image.get(), size, placed);
+    placed.retain_backing(std::move(image));
+    store = std::move(placed);
+}
+
+} // namespace TickSnapshot
+} // namespace backtest
@@ -0,0 +1,193 @@
+#include "distributed/metrics_server.h"
+#include "utils/logging.h"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace backtest {
+
+namespace {
+
+std::string number(double value) {
+    std::ostringstream out;
+    out.precision(15);
+    out << value;
+    return out.str();
+}
+
+std::string quoted(const std::string& text) {
+    std::string out = "\"";
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        if (ch == '\n') out += "\\n";
+        else out += ch;
+    }
+    return out + '"';
+}
+
+} // namespace
+
+void MetricsPage::gauge(const std::string& name, const std::string& help, double value, Labels labels) {
+    add("gauge", name, help, value, std::move(labels));
+}
+
+void MetricsPage::counter(const std::string& name, const std::string& help, double value, Labels labels) {
+    add("counter", name, help, value, std::move(labels));
+}
+
+void MetricsPage::add(const char* type, const std::string& name, const std::string& help, double value, Labels labels) {
+    if (families_.empty() || families_.back().name != name) families_.push_back(Family{name, help, type, {}});
+    families_.back().samples.push_back(Sample{std::move(labels), value});
+}
+
+std::string MetricsPage::prometheus() const {
+    std::ostringstream out;
+    for (const auto& family : families_) {
+        out << "# HELP " << family.name << ' ' << family.help << '\n';
+        out << "# TYPE " << family.name << ' ' << family.type << '\n';
+        for (const auto& sample : family.samples) {
+            out << family.name;
+            if (!sample.labels.empty()) {
+                out << '{';
+                for (size_t i = 0; i < sample.labels.size(); ++i) {
+                    out << (i ? "," : "") << sample.labels[i].first << '=' << quoted(sample.labels[i].second);
+                }
+                out << '}';
+            }
+            if (std::isnan(sample.value)) out << " NaN\n";
+            else if (std::isinf(sample.value)) out << (sample.value > 0 ? " +Inf\n" : " -Inf\n");
+            else out << ' ' << number(sample.value) << '\n';
+        }
+    }
+    return out.str();
+}
+
+std::string MetricsPage::json() const {
+    std::ostringstream out;
+    out << "{\"metrics\":[";
+    for (size_t f = 0; f < families_.size(); ++f) {
+        const auto& family = families_[f];
+        out << (f ? ",\n" : "\n") << "{\"name\":" << quoted(family.name) << ",\"type\":" << quoted(family.type)
+            << ",\"help\":" << quoted(family.help) << ",\"samples\":[";
+        for (size_t s = 0; s < family.samples.size(); ++s) {
+            const auto& sample = family.samples[s];
+            out << (s ? "," : "") << "{\"labels\":{";
+            for (size_t i = 0; i < sample.labels.size(); ++i) {
+                out << (i ? "," : "") << quoted(sample.labels[i].first) << ':' << quoted(sample.labels[i].second);
+            }
+            // JSON has no NaN or infinity
+            out << "},\"value\":" << (std::isfinite(sample.value) ? number(sample.value) : "null") << '}';
+        }
+        out << "]}";
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+#ifdef _WIN32
+
+MetricsServer::MetricsServer(const std::string&, Collector) {
+    throw std::runtime_error("The metrics server is not supported on Windows");
+}
+
+MetricsServer::~MetricsServer() = default;
+
+#else
+
+#ifndef MSG_NOSIGNAL
+    #define MSG_NOSIGNAL 0
+#endif
+
+MetricsServer::MetricsServer(const std::string& endpoint, Collector collect)
+    : endpoint_(Endpoint::parse(endpoint)), collect_(std::move(collect)) {
+    listen_fd_ = listen_on(endpoint_);
+    thread_ = std::thread([this] { serve(); });
+}
+
+MetricsServer::~MetricsServer() {
+    stop_ = true;
+    if (thread_.joinable()) thread_.join();
+    close_listener(listen_fd_, endpoint_);
+}
+
+void MetricsServer::serve() {
+    while (!stop_.load()) {
+        pollfd listener{listen_fd_, POLLIN, 0};
+        if (::poll(&listener, 1, 200) <= 0) continue;
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) continue;
+        try {
+            respond(fd);
+        } catch (const std::exception& e) {
+            Logger::get().warn("MetricsServer", std::string("Request failed: ") + e.what());
+        }
+        ::close(fd);
+    }
+}
+
+void MetricsServer::respond(int fd) {
+    // Request line and headers; a client that stalls gets a second, then is dropped
+    std::string request;
+    while (request.find("\r\n\r\n") == std::string::npos && request.find("\n\n") == std::string::npos &&
+           request.size() < 8192) {
+        pollfd client{fd, POLLIN, 0};
+        if (::poll(&client, 1, 1000) <= 0) return;
+        char chunk[1024];
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        request.append(chunk, static_cast<size_t>(n));
+    }
+
+    std::istringstream line(request.substr(0, request.find('\n')));
+    std::string method, target;
+    line >> method >> target;
+    target = target.substr(0, target.find('?'));
+
+    std::string status = "200 OK";
+    std::string type;
+    std::string body;
+    if (method != "GET" && method != "HEAD") {
+        status = "405 Method Not Allowed";
+        type = "text/plain";
+        body = "Only GET is supported\n";
+    } else if (target == "/metrics" || target == "/metrics.json") {
+        MetricsPage page;
+        collect_(page);
+        if (target == "/metrics") {
+            type = "text/plain; version=0.0.4";
+            body = page.prometheus();
+        } else {
+            type = "application/json";
+            body = page.json();
+        }
+    } else {
+        status = "404 Not Found";
+        type = "text/plain";
+        body = "Try /metrics or /metrics.json\n";
+    }
+
+    std::string response = "HTTP/1.0 " + status + "\r\nContent-Type: " + type +
+                           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    if (method != "HEAD") response += body;
+    const char* p = response.data();
+    size_t left = response.size();
+    while (left > 0) {
+        ssize_t n = ::send(fd, p, left, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+}
+
+#endif
+
+} // namespace backtest
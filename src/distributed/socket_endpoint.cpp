@@ -0,0 +1,142 @@
+#include "distributed/socket_endpoint.h"
+#include <stdexcept>
+
+#ifndef _WIN32
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+#endif
+
+namespace backtest {
+
+#ifdef _WIN32
+
+Endpoint Endpoint::parse(const std::string&) {
+    throw std::runtime_error("Socket endpoints are not supported on Windows");
+}
+
+int listen_on(const Endpoint&) {
+    throw std::runtime_error("Socket endpoints are not supported on Windows");
+}
+
+int try_connect(const Endpoint&) {
+    throw std::runtime_error("Socket endpoints are not supported on Windows");
+}
+
+void close_listener(int, const Endpoint&) {}
+
+#else
+
+namespace {
+
+std::string errno_text() {
+    return std::strerror(errno);
+}
+
+addrinfo* resolve(const Endpoint& endpoint, bool passive) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (passive) hints.ai_flags = AI_PASSIVE;
+    addrinfo* result = nullptr;
+    int rc = ::getaddrinfo(endpoint.host.c_str(), endpoint.port.c_str(), &hints, &result);
+    if (rc != 0) throw std::runtime_error("Could not resolve " + endpoint.host + ": " + gai_strerror(rc));
+    return result;
+}
+
+} // namespace
+
+Endpoint Endpoint::parse(const std::string& text) {
+    Endpoint endpoint;
+    if (text.rfind("unix:", 0) == 0) {
+        endpoint.path = text.substr(5);
+        if (endpoint.path.empty() || endpoint.path.size() >= sizeof(sockaddr_un::sun_path)) {
+            throw std::invalid_argument("Invalid unix socket path: " + text);
+        }
+        return endpoint;
+    }
+    if (text.rfind("tcp:", 0) == 0) {
+        auto colon = text.rfind(':');
+        if (colon <= 4) throw std::invalid_argument("TCP endpoint needs host:port: " + text);
+        endpoint.is_unix = false;
+        endpoint.host = text.substr(4, colon - 4);
+        endpoint.port = text.substr(colon + 1);
+        return endpoint;
+    }
+    throw std::invalid_argument("Endpoint must start with unix: or tcp: (" + text + ")");
+}
+
+int listen_on(const Endpoint& endpoint) {
+    if (endpoint.is_unix) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) throw std::runtime_error("socket: " + errno_text());
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, endpoint.path.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(endpoint.path.c_str());
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 64) != 0) {
+            std::string error = errno_text();
+            ::close(fd);
+            throw std::runtime_error("Could not listen on " + endpoint.path + ": " + error);
+        }
+        return fd;
+    }
+    addrinfo* info = resolve(endpoint, true);
+    int fd = ::socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd < 0) {
+        ::freeaddrinfo(info);
+        throw std::runtime_error("socket: " + errno_text());
+    }
+    int yes = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    bool ok = ::bind(fd, info->ai_addr, info->ai_addrlen) == 0 && ::listen(fd, 64) == 0;
+    ::freeaddrinfo(info);
+    if (!ok) {
+        std::string error = errno_text();
+        ::close(fd);
+        throw std::runtime_error("Could not listen on " + endpoint.host + ":" + endpoint.port + ": " + error);
+    }
+    return fd;
+}
+
+int try_connect(const Endpoint& endpoint) {
+    if (endpoint.is_unix) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, endpoint.path.c_str(), sizeof(addr.sun_path) - 1);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+        ::close(fd);
+        return -1;
+    }
+    addrinfo* info = resolve(endpoint, false);
+    int fd = -1;
+    for (addrinfo* a = info; a && fd < 0; a = a->ai_next) {
+        fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(info);
+    if (fd >= 0) {
+        int yes = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    }
+    return fd;
+}
+
+void close_listener(int fd, const Endpoint& endpoint) {
+    ::close(fd);
+    if (endpoint.is_unix) ::unlink(endpoint.path.c_str());
+}
+
+#endif
+
+} // namespace backtest
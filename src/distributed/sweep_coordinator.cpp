@@ -0,0 +1,746 @@
+#include "distributed/sweep_coordinator.h"
+#include "distributed/metrics_server.h"
+#include "distributed/socket_endpoint.h"
+#include "core/engine.h"
+#include "data/tick_snapshot.h"
+#include "strategy/strategy_base.h"
+#include "strategy/simple_sma_broad_batch.h"
+#include "utils/logging.h"
+#include "utils/memory_placement.h"
+#include "utils/trace.h"
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+    #include <arpa/inet.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <climits>
+#endif
+
+namespace backtest {
+
+SweepResult run_plan_entry(const RunPlan& plan, size_t run, const TickDataStore& store) {
+    TraceSpan span("run");
+    SweepResult result;
+    result.run_index = run;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        Config config = plan.config_for(run);
+        config.log_path.clear();  // Workers never write per-trade logs
+        BacktestEngine engine;
+        engine.configure(config);
+        engine.use_data(store);
+        engine.add_strategy(StrategyFactory::create_from_config(config));
+        engine.run();
+        result.total_pnl = engine.get_results().total_pnl;
+        result.total_trades = engine.get_results().total_trades;
+        result.ticks = engine.get_stats().events_processed;
+    } catch (const std::exception& e) {
+        Logger::get().error("SweepWorker", "Run " + std::to_string(run) + " failed: " + e.what());
+        result.status = 1;
+    }
+    result.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+namespace {
+
+// Swept strategy parameters that a clone of the base strategy accepts mid-run
+std::vector<bool> late_binding_keys(const RunPlan& plan, const StrategyBase& probe) {
+    std::vector<bool> late(plan.param_count(), false);
+    auto copy = probe.clone();
+    if (!copy) return late;
+    for (size_t p = 0; p < plan.param_count(); ++p) {
+        const std::string& key = plan.param_keys()[p];
+        if (key.rfind("strategy.", 0) != 0 || key == "strategy.warmup_ticks" || key == "strategy.conflation_seconds") continue;
+        late[p] = copy->set_parameter(key.substr(9), plan.run_values(0)[p]);
+    }
+    return late;
+}
+
+struct ForkVariant {
+    size_t run = 0;
+    bool agrees = true;                           // Still identical to the base run
+    std::shared_ptr<const BacktestEngine> checkpoint;  // Last state it agreed with
+};
+
+void fill_result(SweepResult& result, const BacktestEngine& engine) {
+    result.total_pnl = engine.get_results().total_pnl;
+    result.total_trades = engine.get_results().total_trades;
+    result.ticks = engine.get_stats().events_processed;
+}
+
+} // namespace
+
+std::vector<SweepResult> run_plan_forked(const RunPlan& plan, const std::vector<size_t>& runs,
+                                         const TickDataStore& store, size_t checkpoint_ticks) {
+    TraceSpan span("run_forked");
+    std::vector<SweepResult> results;
+    if (runs.empty()) return results;
+    Config base_config = plan.config_for(runs[0]);
+    auto probe = StrategyFactory::create_from_config(base_config);
+    const std::vector<bool> late = late_binding_keys(plan, *probe);
+    
+    // Group runs whose parameters differ only in late-binding keys
+    std::map<std::vector<double>, std::vector<size_t>> groups;
+    for (size_t run : runs) {
+        std::vector<double> fixed;
+        for (size_t p = 0; p < plan.param_count(); ++p) {
+            if (!late[p]) fixed.push_back(plan.run_values(run)[p]);
+        }
+        groups[fixed].push_back(run);
+    }
+    
+    for (const auto& [fixed, members] : groups) {
+        auto start = std::chrono::steady_clock::now();
+        const size_t base_run = members[0];
+        SweepResult base_result;
+        base_result.run_index = base_run;
+        std::vector<ForkVariant> variants;
+        for (size_t i = 1; i < members.size(); ++i) variants.push_back({members[i], true, nullptr});
+        try {
+            Config config = plan.config_for(base_run);
+            config.log_path.clear();
+            BacktestEngine engine;
+            engine.configure(config);
+            engine.use_data(store);
+            engine.add_strategy(StrategyFactory::create_from_config(config));
+            if (!engine.start()) throw std::runtime_error("Nothing to run");
+            const StrategyBase& strategy = *engine.get_strategies()[0];
+            bool more = true;
+            while (more) {
+                more = engine.advance(checkpoint_ticks);
+                bool any_agree = false;
+                for (auto& variant : variants) {
+                    if (!variant.agrees) continue;
+                    for (size_t p = 0; p < plan.param_count() && variant.agrees; ++p) {
+                        if (late[p]) {
+                            variant.agrees = strategy.parameter_agrees(plan.param_keys()[p].substr(9),
+                                                                        plan.run_values(variant.run)[p]);
+                        }
+                    }
+                    any_agree = any_agree || variant.agrees;
+                }
+                if (!any_agree) {
+                    while (more) more = engine.advance(std::numeric_limits<size_t>::max());
+                    break;
+                }
+                if (more) {
+                    std::shared_ptr<const BacktestEngine> checkpoint = engine.fork();
+                    for (auto& variant : variants) {
+                        if (variant.agrees) variant.checkpoint = checkpoint;
+                    }
+                }
+            }
+            engine.finish();
+            fill_result(base_result, engine);
+            
+            for (auto& variant : variants) {
+                SweepResult result;
+                result.run_index = variant.run;
+                if (variant.agrees) {
+                    // Every decision matched the base run to the end
+                    result.total_pnl = base_result.total_pnl;
+                    result.total_trades = base_result.total_trades;
+                } else if (variant.checkpoint) {
+                    auto child = variant.checkpoint->fork();
+                    StrategyBase& forked = *child->get_strategies()[0];
+                    for (size_t p = 0; p < plan.param_count(); ++p) {
+                        if (late[p]) forked.set_parameter(plan.param_keys()[p].substr(9), plan.run_values(variant.run)[p]);
+                    }
+                    while (child->advance(std::numeric_limits<size_t>::max())) {}
+                    child->finish();
+                    fill_result(result, *child);
+                } else {
+                    result = run_plan_entry(plan, variant.run, store);
+                }
+                results.push_back(result);
+            }
+        } catch (const std::exception& e) {
+            Logger::get().error("SweepWorker", "Forked group of run " + std::to_string(base_run) + " failed: " + e.what());
+            base_result.status = 1;
+            for (const auto& variant : variants) {
+                SweepResult failed;
+                failed.run_index = variant.run;
+                failed.status = 1;
+                results.push_back(failed);
+            }
+        }
+        results.push_back(base_result);
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        for (size_t i = results.size() - members.size(); i < results.size(); ++i) {
+            results[i].elapsed_ms = elapsed / static_cast<double>(members.size());
+            // Forks resume a replay already counted, so only the shared replay's ticks are split
+            results[i].ticks = base_result.ticks / members.size();
+        }
+    }
+    std::sort(results.begin(), results.end(),
+              [](const SweepResult& a, const SweepResult& b) { return a.run_index < b.run_index; });
+    return results;
+}
+
+bool plan_is_batchable(const RunPlan& plan) {
+    if (plan.base().strategy.type != "simple_sma_broad") return false;
+    for (const auto& key : plan.param_keys()) {
+        // Warm-up and conflation change which ticks are delivered, so they cannot vary across lanes
+        if (key == "strategy.warmup_ticks" || key == "strategy.conflation_seconds") return false;
+        if (key != "run.initial_capital" && key.rfind("strategy.", 0) != 0) return false;
+    }
+    return true;
+}
+
+std::vector<SweepResult> run_plan_batch(const RunPlan& plan, const std::vector<size_t>& runs,
+                                        const TickDataStore& store) {
+    TraceSpan span("run_batch");
+    std::vector<SweepResult> results(runs.size());
+    auto start = std::chrono::steady_clock::now();
+    try {
+        // Engine and session settings come from the first run; lanes differ only in parameters
+        Config config = plan.config_for(runs.at(0));
+        config.log_path.clear();
+        BacktestEngine engine;
+        engine.configure(config);
+        engine.use_data(store);
+        auto batch = std::make_unique<SimpleSMABroadBatchStrategy>(config.strategy.id);
+        auto shape = StrategyFactory::create_from_config(config);
+        for (const auto& instrument : shape->subscriptions()) batch->subscribe(instrument);
+        batch->set_session(shape->session());
+        batch->set_conflation(shape->conflation());
+        for (size_t run : runs) batch->add_lane(plan.config_for(run));
+        auto* lanes = batch.get();
+        engine.add_strategy(std::move(batch));
+        engine.run();
+        for (size_t i = 0; i < runs.size(); ++i) {
+            results[i].total_pnl = lanes->lane_pnl(i);
+            results[i].total_trades = lanes->lane_trades(i);
+            results[i].ticks = engine.get_stats().events_processed / runs.size();
+        }
+    } catch (const std::exception& e) {
+        Logger::get().error("SweepWorker", "Batch starting at run " + std::to_string(runs.empty() ? 0 : runs[0]) +
+                                           " failed: " + e.what());
+        for (auto& result : results) result.status = 1;
+    }
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    for (size_t i = 0; i < runs.size(); ++i) {
+        results[i].run_index = runs[i];
+        results[i].elapsed_ms = elapsed / static_cast<double>(runs.size());
+    }
+    return results;
+}
+
+SweepProgress::Worker* SweepProgress::worker(uint32_t pid) {
+    for (size_t i = 0; i < worker_count; ++i) {
+        if (workers[i].pid == pid) return &workers[i];
+    }
+    if (worker_count == kMaxWorkers) return nullptr;
+    workers[worker_count].pid = pid;
+    return &workers[worker_count++];
+}
+
+void SweepProgress::record(const SweepResult& result) {
+    ++completed_runs;
+    if (Worker* w = worker(result.worker_pid)) {
+        ++w->tasks;
+        w->ticks += result.ticks;
+        w->busy_ms += result.elapsed_ms;
+    }
+    if (result.status != 0) {
+        ++failed_runs;
+        return;
+    }
+    size_t rank = best_count;
+    while (rank > 0 && best[rank - 1].total_pnl < result.total_pnl) --rank;
+    if (rank == kBestRuns) return;
+    for (size_t i = std::min<size_t>(best_count, kBestRuns - 1); i > rank; --i) best[i] = best[i - 1];
+    best[rank] = result;
+    best_count = std::min<size_t>(best_count + 1, kBestRuns);
+}
+
+void add_sweep_metrics(MetricsPage& page, const SweepProgress& progress) {
+    const double elapsed = progress.elapsed_seconds;
+    page.gauge("nemo_sweep_runs", "Runs in the plan", static_cast<double>(progress.total_runs));
+    page.counter("nemo_sweep_runs_completed_total", "Runs with a result", static_cast<double>(progress.completed_runs));
+    page.counter("nemo_sweep_runs_failed_total", "Runs that failed", static_cast<double>(progress.failed_runs));
+    page.gauge("nemo_sweep_tasks_per_second", "Runs completed per second since the sweep started",
+               elapsed > 0 ? static_cast<double>(progress.completed_runs) / elapsed : 0.0);
+    page.gauge("nemo_sweep_elapsed_seconds", "Time since the sweep started", elapsed);
+    page.gauge("nemo_sweep_queue_depth", "Tasks waiting for a worker", static_cast<double>(progress.pending_tasks));
+    page.counter("nemo_sweep_tasks_requeued_total", "Tasks put back after their worker was lost",
+                 static_cast<double>(progress.requeued_tasks));
+    page.gauge("nemo_sweep_workers_connected", "Workers connected now", static_cast<double>(progress.connected_workers));
+
+    page.gauge("nemo_memory_bytes", "Memory by subsystem", static_cast<double>(progress.data_bytes),
+               {{"subsystem", "market_data"}});
+    page.gauge("nemo_memory_bytes", "Memory by subsystem", static_cast<double>(progress.rss_bytes),
+               {{"subsystem", "process"}});
+    for (size_t i = 0; i < progress.worker_count; ++i) {
+        const auto& w = progress.workers[i];
+        if (w.rss_bytes) {
+            page.gauge("nemo_memory_bytes", "Memory by subsystem", static_cast<double>(w.rss_bytes),
+                       {{"subsystem", "worker"}, {"worker", std::to_string(w.pid)}});
+        }
+    }
+
+    auto per_worker = [&](const char* name, const char* help, bool is_counter, auto value) {
+        for (size_t i = 0; i < progress.worker_count; ++i) {
+            const auto& w = progress.workers[i];
+            MetricsPage::Labels labels = {{"worker", std::to_string(w.pid)}};
+            if (is_counter) page.counter(name, help, value(w), std::move(labels));
+            else page.gauge(name, help, value(w), std::move(labels));
+        }
+    };
+    using Worker = SweepProgress::Worker;
+    per_worker("nemo_worker_busy", "1 while the worker holds a task", false,
+               [](const Worker& w) { return static_cast<double>(w.busy); });
+    per_worker("nemo_worker_tasks_total", "Runs finished by the worker", true,
+               [](const Worker& w) { return static_cast<double>(w.tasks); });
+    per_worker("nemo_worker_ticks_total", "Ticks replayed by the worker", true,
+               [](const Worker& w) { return static_cast<double>(w.ticks); });
+    per_worker("nemo_worker_busy_seconds_total", "Time the worker spent running tasks", true,
+               [](const Worker& w) { return w.busy_ms / 1000.0; });
+    per_worker("nemo_worker_ticks_per_second", "Replay throughput of the worker while busy", false,
+               [](const Worker& w) { return w.busy_ms > 0 ? static_cast<double>(w.ticks) * 1000.0 / w.busy_ms : 0.0; });
+
+    for (size_t i = 0; i < progress.best_count; ++i) {
+        page.gauge("nemo_sweep_best_pnl", "P&L of the most profitable runs so far", progress.best[i].total_pnl,
+                   {{"rank", std::to_string(i + 1)}, {"run", std::to_string(progress.best[i].run_index)}});
+    }
+    for (size_t i = 0; i < progress.best_count; ++i) {
+        page.gauge("nemo_sweep_best_trades", "Trades of the most profitable runs so far",
+                   static_cast<double>(progress.best[i].total_trades),
+                   {{"rank", std::to_string(i + 1)}, {"run", std::to_string(progress.best[i].run_index)}});
+    }
+}
+
+SweepCoordinator::SweepCoordinator(SweepCoordinatorOptions options)
+    : options_(std::move(options)) {
+    if (options_.endpoint.empty()) throw std::invalid_argument("Sweep coordinator needs an endpoint");
+    if (options_.plan_path.empty()) throw std::invalid_argument("Sweep coordinator needs a run plan");
+    if (options_.snapshot_path.empty()) options_.snapshot_path = options_.plan_path + ".snap";
+}
+
+void write_sweep_results(const RunPlan& plan, const std::vector<SweepResult>& results, const std::string& path) {
+    TraceSpan span("export_results");
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) throw std::runtime_error("Could not write sweep results: " + path);
+    out << "run";
+    for (const auto& key : plan.param_keys()) out << "," << key;
+    out << ",total_pnl,total_trades,elapsed_ms,status,worker_pid\n";
+    out << std::setprecision(10);
+    for (const auto& r : results) {
+        out << r.run_index;
+        const double* values = plan.run_values(r.run_index);
+        for (size_t p = 0; p < plan.param_count(); ++p) out << "," << values[p];
+        out << "," << r.total_pnl << "," << r.total_trades << "," << r.elapsed_ms
+            << "," << r.status << "," << r.worker_pid << "\n";
+    }
+}
+
+#ifdef _WIN32
+
+std::vector<SweepResult> SweepCoordinator::run() {
+    throw std::runtime_error("Distributed sweeps are not supported on Windows");
+}
+
+int run_sweep_worker(const SweepWorkerOptions&) {
+    throw std::runtime_error("Distributed sweeps are not supported on Windows");
+}
+
+#else
+
+#ifndef MSG_NOSIGNAL
+    #define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+// Wire protocol: every message is a fixed header followed by `length` payload bytes.
+//
+//   worker -> HELLO(pid)                 coordinator -> WELCOME(plan \0 snapshot)
+//   worker -> READY                      coordinator -> TASK(run) | SHUTDOWN
+//   worker -> RESULT(SweepResult)        (a RESULT also means "ready for more")
+enum class MessageType : uint32_t {
+    HELLO = 1,
+    WELCOME,
+    READY,
+    TASK,
+    RESULT,
+    SHUTDOWN
+};
+
+struct FrameHeader {
+    uint32_t type;
+    uint32_t length;
+};
+
+constexpr uint32_t kMaxPayload = 1 << 20;
+
+std::string errno_text() {
+    return std::strerror(errno);
+}
+
+bool send_all(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool recv_all(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::recv(fd, p, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool send_message(int fd, MessageType type, const void* payload = nullptr, uint32_t length = 0) {
+    FrameHeader header{static_cast<uint32_t>(type), length};
+    return send_all(fd, &header, sizeof(header)) && (length == 0 || send_all(fd, payload, length));
+}
+
+// Blocking read of one whole message (worker side)
+bool recv_message(int fd, MessageType& type, std::vector<char>& payload) {
+    FrameHeader header;
+    if (!recv_all(fd, &header, sizeof(header)) || header.length > kMaxPayload) return false;
+    type = static_cast<MessageType>(header.type);
+    payload.resize(header.length);
+    return header.length == 0 || recv_all(fd, payload.data(), header.length);
+}
+
+// Coordinator-side view of one connected worker
+struct WorkerConnection {
+    int fd = -1;
+    uint32_t pid = 0;
+    bool ready = false;     // Waiting for a task
+    bool has_task = false;
+    uint64_t task = 0;
+    std::vector<char> buffer;  // Bytes received but not yet framed
+};
+
+pid_t spawn_worker(const std::string& executable, const std::string& endpoint,
+                   const std::vector<std::string>& extra_args) {
+    std::vector<std::string> args = {executable, "--worker", endpoint};
+    args.insert(args.end(), extra_args.begin(), extra_args.end());
+    pid_t pid = ::fork();
+    if (pid < 0) throw std::runtime_error("fork: " + errno_text());
+    if (pid == 0) {
+        std::vector<char*> argv;
+        for (auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+        argv.push_back(nullptr);
+        ::execv(executable.c_str(), argv.data());
+        ::_exit(127);
+    }
+    return pid;
+}
+
+std::string self_executable() {
+    char path[PATH_MAX];
+    ssize_t n = ::readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (n <= 0) throw std::runtime_error("Could not locate the nemo executable; set worker_executable");
+    return std::string(path, static_cast<size_t>(n));
+}
+
+} // namespace
+
+std::vector<SweepResult> SweepCoordinator::run() {
+    Logger& logger = Logger::get();
+    RunPlan plan = RunPlan::load(options_.plan_path);
+    const size_t total = plan.run_count();
+
+    // Load every CSV once and publish it as a mapped snapshot for the workers
+    {
+        BacktestEngine loader;
+        loader.load_data(plan.base());
+        loader.save_snapshot(options_.snapshot_path);
+    }
+    logger.info("SweepCoordinator", "Snapshot written to " + options_.snapshot_path +
+                ", dispatching " + std::to_string(total) + " runs");
+
+    Endpoint endpoint = Endpoint::parse(options_.endpoint);
+    int listen_fd = listen_on(endpoint);
+
+    std::string welcome = options_.plan_path + '\0' + options_.snapshot_path;
+    std::deque<uint64_t> pending;
+    for (uint64_t i = 0; i < total; ++i) pending.push_back(i);
+    std::vector<SweepResult> results(total);
+    std::vector<bool> done(total, false);
+    size_t completed = 0;
+    std::vector<WorkerConnection> workers;
+    std::vector<pid_t> children;
+    size_t respawns = 0;
+    requeued_tasks_ = 0;
+    const auto started = std::chrono::steady_clock::now();
+    SweepProgress state;
+    state.total_runs = total;
+    std::error_code ec;
+    state.data_bytes = std::filesystem::file_size(options_.snapshot_path, ec);
+    progress_.store(state);
+
+    std::string executable = options_.worker_executable;
+    if (options_.local_workers > 0 && executable.empty()) executable = self_executable();
+    const bool spread = plan.base().numa == "replicate" && numa_node_count() > 1;
+    auto worker_args = [&](size_t index) {
+        auto args = options_.worker_args;
+        if (spread) args.insert(args.end(), {"--numa-node", std::to_string(index % numa_node_count())});
+        return args;
+    };
+    for (size_t i = 0; i < options_.local_workers; ++i) {
+        children.push_back(spawn_worker(executable, options_.endpoint, worker_args(i)));
+    }
+
+    auto drop_worker = [&](size_t index) {
+        WorkerConnection& worker = workers[index];
+        if (worker.has_task && !done[worker.task]) {
+            pending.push_front(worker.task);
+            ++requeued_tasks_;
+            logger.warn("SweepCoordinator", "Worker " + std::to_string(worker.pid) +
+                        " lost while running task " + std::to_string(worker.task) + ", re-queued");
+        }
+        ::close(worker.fd);
+        workers.erase(workers.begin() + static_cast<std::ptrdiff_t>(index));
+    };
+
+    // Returns false if the connection sent something malformed
+    auto handle_message = [&](WorkerConnection& worker, MessageType type, const char* payload, uint32_t length) {
+        switch (type) {
+            case MessageType::HELLO:
+                if (length >= sizeof(uint32_t)) std::memcpy(&worker.pid, payload, sizeof(uint32_t));
+                return send_message(worker.fd, MessageType::WELCOME, welcome.data(),
+                                    static_cast<uint32_t>(welcome.size()));
+            case MessageType::READY:
+                worker.ready = true;
+                return true;
+            case MessageType::RESULT: {
+                if (length != sizeof(SweepResult)) return false;
+                SweepResult result;
+                std::memcpy(&result, payload, sizeof(result));
+                if (result.run_index >= total) return false;
+                if (!done[result.run_index]) {
+                    done[result.run_index] = true;
+                    results[result.run_index] = result;
+                    ++completed;
+                    state.record(result);
+                }
+                worker.has_task = false;
+                worker.ready = true;
+                return true;
+            }
+            default:
+                return false;
+        }
+    };
+
+    auto last_publish = started;
+    auto publish = [&](bool force) {
+        const auto now = std::chrono::steady_clock::now();
+        if (!force && now - last_publish < std::chrono::milliseconds(100)) return;
+        last_publish = now;
+        state.pending_tasks = pending.size();
+        state.requeued_tasks = requeued_tasks_;
+        state.connected_workers = workers.size();
+        state.elapsed_seconds = std::chrono::duration<double>(now - started).count();
+        state.rss_bytes = resident_bytes();
+        for (size_t i = 0; i < state.worker_count; ++i) {
+            state.workers[i].busy = 0;
+            state.workers[i].rss_bytes = 0;
+        }
+        for (const auto& worker : workers) {
+            if (worker.pid == 0) continue;
+            if (auto* entry = state.worker(worker.pid)) entry->busy = worker.has_task ? 1 : 0;
+        }
+        for (pid_t child : children) {
+            if (auto* entry = state.worker(static_cast<uint32_t>(child))) entry->rss_bytes = resident_bytes(child);
+        }
+        progress_.store(state);
+    };
+
+    while (completed < total) {
+        // Hand out work to idle workers
+        for (size_t i = 0; i < workers.size() && !pending.empty();) {
+            WorkerConnection& worker = workers[i];
+            if (!worker.ready) { ++i; continue; }
+            uint64_t task = pending.front();
+            pending.pop_front();
+            if (done[task]) continue;
+            worker.ready = false;
+            worker.has_task = true;
+            worker.task = task;
+            if (!send_message(worker.fd, MessageType::TASK, &task, sizeof(task))) {
+                drop_worker(i);
+                continue;
+            }
+            ++i;
+        }
+
+        if (Trace::enabled()) {
+            Trace::counter("pending_tasks", static_cast<int64_t>(pending.size()));
+            Trace::counter("busy_workers", std::count_if(workers.begin(), workers.end(),
+                                                         [](const WorkerConnection& w) { return w.has_task; }));
+            Trace::counter("completed_runs", static_cast<int64_t>(completed));
+        }
+        publish(false);
+
+        // Reap local children and replace the ones that died
+        for (size_t i = 0; i < children.size();) {
+            int status = 0;
+            if (::waitpid(children[i], &status, WNOHANG) != children[i]) { ++i; continue; }
+            logger.warn("SweepCoordinator", "Local worker " + std::to_string(children[i]) + " exited");
+            children.erase(children.begin() + static_cast<std::ptrdiff_t>(i));
+            if (respawns < options_.max_respawns) {
+                children.push_back(spawn_worker(executable, options_.endpoint,
+                                                worker_args(options_.local_workers + respawns)));
+                ++respawns;
+            }
+        }
+        if (options_.local_workers > 0 && children.empty() && workers.empty()) {
+            close_listener(listen_fd, endpoint);
+            throw std::runtime_error("All sweep workers exited with " +
+                                     std::to_string(total - completed) + " runs outstanding");
+        }
+
+        std::vector<pollfd> fds;
+        fds.push_back({listen_fd, POLLIN, 0});
+        for (const auto& worker : workers) fds.push_back({worker.fd, POLLIN, 0});
+        int rc = ::poll(fds.data(), fds.size(), 200);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("poll: " + errno_text());
+        }
+        if (rc == 0) continue;
+
+        if (fds[0].revents & POLLIN) {
+            int fd = ::accept(listen_fd, nullptr, nullptr);
+            if (fd >= 0) workers.emplace_back().fd = fd;
+        }
+
+        // Walk backwards so dropping a worker does not shift unvisited entries
+        for (size_t i = fds.size() - 1; i >= 1; --i) {
+            if (fds[i].revents == 0) continue;
+            WorkerConnection& worker = workers[i - 1];
+            char chunk[4096];
+            ssize_t n = ::recv(worker.fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                drop_worker(i - 1);
+                continue;
+            }
+            worker.buffer.insert(worker.buffer.end(), chunk, chunk + n);
+
+            bool ok = true;
+            size_t offset = 0;
+            while (ok && worker.buffer.size() - offset >= sizeof(FrameHeader)) {
+                FrameHeader header;
+                std::memcpy(&header, worker.buffer.data() + offset, sizeof(header));
+                if (header.length > kMaxPayload) { ok = false; break; }
+                if (worker.buffer.size() - offset < sizeof(header) + header.length) break;
+                ok = handle_message(worker, static_cast<MessageType>(header.type),
+                                    worker.buffer.data() + offset + sizeof(header), header.length);
+                offset += sizeof(header) + header.length;
+            }
+            worker.buffer.erase(worker.buffer.begin(), worker.buffer.begin() + static_cast<std::ptrdiff_t>(offset));
+            if (!ok) drop_worker(i - 1);
+        }
+    }
+
+    publish(true);
+    for (const auto& worker : workers) {
+        send_message(worker.fd, MessageType::SHUTDOWN);
+        ::close(worker.fd);
+    }
+    close_listener(listen_fd, endpoint);
+    for (pid_t child : children) ::waitpid(child, nullptr, 0);
+
+    logger.info("SweepCoordinator", "Sweep finished: " + std::to_string(total) + " runs, " +
+                std::to_string(requeued_tasks_) + " re-queued");
+    if (!options_.results_path.empty()) write_sweep_results(plan, results, options_.results_path);
+    return results;
+}
+
+int run_sweep_worker(const SweepWorkerOptions& options) {
+    Endpoint endpoint = Endpoint::parse(options.endpoint);
+
+    // The coordinator may still be writing its snapshot; keep retrying for a while
+    int fd = -1;
+    for (int attempt = 0; attempt < 100 && fd < 0; ++attempt) {
+        fd = try_connect(endpoint);
+        if (fd < 0) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (fd < 0) throw std::runtime_error("Could not connect to coordinator at " + options.endpoint);
+
+    uint32_t pid = static_cast<uint32_t>(::getpid());
+    MessageType type;
+    std::vector<char> payload;
+    if (!send_message(fd, MessageType::HELLO, &pid, sizeof(pid)) ||
+        !recv_message(fd, type, payload) || type != MessageType::WELCOME) {
+        ::close(fd);
+        throw std::runtime_error("Coordinator handshake failed");
+    }
+    std::string welcome(payload.begin(), payload.end());
+    auto split = welcome.find('\0');
+    if (split == std::string::npos) {
+        ::close(fd);
+        throw std::runtime_error("Malformed coordinator welcome");
+    }
+
+    RunPlan plan = RunPlan::load(welcome.substr(0, split));
+    TickDataStore store;
+    TickSnapshot::map_file(welcome.substr(split + 1), store);
+    // Pin first, so a node-local replica is allocated and first touched where it is read
+    MemoryPlacement placement = MemoryPlacement::parse(plan.base().huge_pages, plan.base().numa);
+    if (options.numa_node >= 0) {
+        if (!pin_to_numa_node(options.numa_node)) {
+            Logger::get().warn("SweepWorker", "Could not pin to NUMA node " + std::to_string(options.numa_node));
+        }
+        placement.node = options.numa_node;
+    }
+    if (!placement.is_default()) TickSnapshot::place(store, placement);
+
+    size_t tasks_done = 0;
+    send_message(fd, MessageType::READY);
+    while (recv_message(fd, type, payload) && type == MessageType::TASK) {
+        if (payload.size() != sizeof(uint64_t)) break;
+        if (options.crash_after > 0 && tasks_done >= options.crash_after) {
+            ::_exit(3);  // Simulated crash: task is left unanswered
+        }
+        uint64_t run;
+        std::memcpy(&run, payload.data(), sizeof(run));
+        SweepResult result = run_plan_entry(plan, static_cast<size_t>(run), store);
+        result.worker_pid = pid;
+        if (!send_message(fd, MessageType::RESULT, &result, sizeof(result))) break;
+        ++tasks_done;
+    }
+    ::close(fd);
+    return 0;
+}
+
+#endif
+
+} // namespace backtest
@@ -1,17 +1,446 @@
 #include "core/engine.h"
+#include "core/result_cache.h"
+#include "data/shared_tick_cache.h"
+#include "data/tick_snapshot.h"
+#include "strategy/strategy_base.h"
+#include "utils/config.h"
+#include "distributed/metrics_server.h"
+#include "distributed/sweep_coordinator.h"
+#include "strategy/simple_sma_broad_batch.h"
 #include "algo/simple_moving_average.h"
 #include "metrics/backtester.h"
 #include "data_loader.h"
 #include "utils/logging.h"
+#include "utils/memory_placement.h"
+#include "utils/trace.h"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <filesystem>
 #include <memory>
 #include <iomanip>
 #include <map>
+#include <optional>
+#include <sstream>
 #include <vector>
 
 using namespace backtest;
 
+namespace {
+
+// Throughput plus, where the kernel allows it, hardware counts per replayed
+// tick for each engine stage (--perf)
+void print_engine_stats(const BacktestEngine& engine) {
+    using Stage = BacktestEngine::Stage;
+    const auto& stats = engine.get_stats();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n==== ENGINE STATS ====" << std::endl;
+    std::cout << "Ticks: " << stats.events_processed << " in "
+              << std::chrono::duration<double, std::milli>(stats.total_processing_time).count() << " ms ("
+              << stats.events_per_second << " ticks/s)" << std::endl;
+    const PerfCounters* perf = engine.perf_counters();
+    if (!perf || !perf->any_hardware()) {
+        std::cout << "Hardware counters unavailable (no PMU, or kernel.perf_event_paranoid too high)" << std::endl;
+    }
+    const double ticks = static_cast<double>(std::max<size_t>(stats.events_processed, 1));
+    std::cout << "Per tick     ";
+    for (size_t e = 0; e < PerfCounters::kEventCount; ++e) {
+        std::cout << std::setw(15) << PerfCounters::name(static_cast<PerfCounters::Event>(e));
+    }
+    std::cout << std::setw(8) << "IPC" << std::endl;
+    for (size_t s = 0; s < BacktestEngine::kStageCount; ++s) {
+        const auto& counts = stats.stage_counters[s];
+        std::cout << std::left << std::setw(13) << BacktestEngine::stage_name(static_cast<Stage>(s)) << std::right;
+        for (size_t e = 0; e < PerfCounters::kEventCount; ++e) {
+            if (perf && perf->has(static_cast<PerfCounters::Event>(e))) {
+                std::cout << std::setw(15) << static_cast<double>(counts.values[e]) / ticks;
+            } else {
+                std::cout << std::setw(15) << "n/a";
+            }
+        }
+        const auto cycles = counts[PerfCounters::Cycles];
+        if (cycles > 0) {
+            std::cout << std::setw(8) << static_cast<double>(counts[PerfCounters::Instructions]) / static_cast<double>(cycles);
+        } else {
+            std::cout << std::setw(8) << "n/a";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "======================" << std::endl;
+}
+
+// Ticks between published snapshots when only --metrics asks for them
+constexpr size_t kMetricsProgressTicks = 16384;
+
+// Progress of a single run for --metrics, from the engine's published snapshot
+void add_run_metrics(MetricsPage& page, const BacktestEngine::ProgressSnapshot& progress, double elapsed_seconds) {
+    page.counter("nemo_run_ticks_replayed_total", "Ticks replayed so far", static_cast<double>(progress.ticks_replayed));
+    page.gauge("nemo_run_ticks", "Ticks the run will replay", static_cast<double>(progress.total_ticks));
+    page.gauge("nemo_run_progress_ratio", "Share of the ticks replayed", progress.fraction());
+    page.gauge("nemo_run_ticks_per_second", "Replay throughput since the run started",
+               elapsed_seconds > 0 ? static_cast<double>(progress.ticks_replayed) / elapsed_seconds : 0.0);
+    page.gauge("nemo_run_pnl", "Strategies' P&L", progress.pnl);
+    page.gauge("nemo_run_max_drawdown", "Largest fall from peak P&L", progress.max_drawdown);
+    page.counter("nemo_run_trades_total", "Trades so far", static_cast<double>(progress.trades));
+    page.gauge("nemo_run_done", "1 once the run has finished", static_cast<double>(progress.done));
+    page.gauge("nemo_memory_bytes", "Memory by subsystem", static_cast<double>(progress.data_bytes),
+               {{"subsystem", "market_data"}});
+    page.gauge("nemo_memory_bytes", "Memory by subsystem", static_cast<double>(progress.arena_spill_bytes),
+               {{"subsystem", "run_arena_spill"}});
+    page.gauge("nemo_memory_bytes", "Memory by subsystem", static_cast<double>(resident_bytes()),
+               {{"subsystem", "process"}});
+}
+
+// Run one fully resolved configuration through the event-driven engine. With
+// run.cache_dir set, identical data + config + strategy version is answered
+// from the result cache; --no-cache bypasses it, --refresh-cache re-runs and
+// replaces the entry, --clear-cache empties the directory first. --state <file>
+// continues from that checkpoint when it exists (reading only rows appended
+// since) and writes the new end-of-run state back; it does not use the cache.
+// --perf prints throughput and per-stage hardware counters after the run.
+// --progress-ticks N / --progress-seconds S (simulated) print progress to
+// stderr from a monitor thread that reads the engine's published snapshots.
+// --metrics <endpoint> serves the same snapshots over HTTP while the run lasts.
+BacktestEngine::BacktestResults run_configured(const Config& config, const std::map<std::string, std::string>& args) {
+    BacktestEngine engine;
+    engine.configure(config);
+    engine.enable_perf_counters(args.count("perf") > 0);
+    const std::string state = args.count("state") ? args.at("state") : "";
+    if (!state.empty() && std::filesystem::exists(state)) {
+        const size_t rows = engine.load_checkpoint(state, config);
+        std::cout << "Resumed from " << state << " (" << rows << " new rows)" << std::endl;
+    } else {
+        engine.load_data(config);
+    }
+    auto strategy = StrategyFactory::create_from_config(config);
+    
+    std::optional<ResultCache> cache;
+    uint64_t key = 0;
+    if (!config.cache_dir.empty() && state.empty() && !args.count("no-cache")) {
+        cache.emplace(config.cache_dir);
+        if (args.count("clear-cache")) {
+            std::cout << "Cleared " << cache->clear() << " cached results from " << config.cache_dir << std::endl;
+        }
+        key = ResultCache::key(engine.get_data_store(), config, strategy->version());
+        if (args.count("refresh-cache")) cache->invalidate(key);
+        if (auto hit = cache->lookup(key)) {
+            std::cout << "Result cache hit: " << cache->path_for(key) << std::endl;
+            return *hit;
+        }
+    }
+    engine.add_strategy(std::move(strategy));
+    if (args.count("progress-ticks") || args.count("progress-seconds")) {
+        const size_t ticks = args.count("progress-ticks") ? std::stoul(args.at("progress-ticks")) : 0;
+        const double seconds = args.count("progress-seconds") ? std::stod(args.at("progress-seconds")) : 0.0;
+        engine.set_progress_interval(ticks, std::chrono::duration_cast<Duration>(std::chrono::duration<double>(seconds)));
+        auto fraction = std::make_shared<double>(0.0);
+        engine.set_progress_callback([fraction](double done) { *fraction = done; });
+        engine.set_update_callback([fraction](const BacktestEngine::BacktestResults& partial) {
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1) << "Progress " << *fraction * 100 << "% | P&L $"
+                 << std::setprecision(2) << partial.total_pnl << " | trades " << partial.total_trades
+                 << " | max drawdown $" << partial.max_drawdown << '\n';
+            std::cerr << line.str();
+        });
+        engine.start_progress_monitor(std::chrono::milliseconds(200));
+    } else if (args.count("metrics")) {
+        engine.set_progress_interval(kMetricsProgressTicks, Duration::zero());
+    }
+    std::optional<MetricsServer> metrics;
+    if (args.count("metrics")) {
+        const auto started = std::chrono::steady_clock::now();
+        metrics.emplace(args.at("metrics"), [&engine, started](MetricsPage& page) {
+            const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            add_run_metrics(page, engine.progress().load(), elapsed);
+        });
+    }
+    engine.run();
+    engine.stop_progress_monitor();
+    if (args.count("perf")) print_engine_stats(engine);
+    if (cache) cache->store(key, engine.get_results());
+    if (!state.empty()) engine.save_checkpoint(state);
+    return engine.get_results();
+}
+
+void print_engine_results(const Config& config, const BacktestEngine::BacktestResults& results) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n==== BACKTEST RESULTS SUMMARY ====" << std::endl;
+    std::cout << "Strategy: " << config.strategy.type << " (" << config.strategy.id << ")" << std::endl;
+    std::cout << "Initial Equity: $" << config.initial_capital << std::endl;
+    std::cout << "Total P&L: $" << results.total_pnl << std::endl;
+    std::cout << "Total Trades: " << results.total_trades << std::endl;
+    if (!results.session_pnl.empty()) {
+        auto worst = std::min_element(results.session_pnl.begin(), results.session_pnl.end());
+        std::cout << "Sessions: " << results.session_pnl.size() << " (worst session P&L $" << *worst << ")" << std::endl;
+    }
+    std::cout << "==================================\n" << std::endl;
+}
+
+// Command line: --config <file.toml> [--compile-plan <out.plan> | --write-archive <dir> [--block-rows N]]
+//               | --plan <file.plan> [--run N]
+//                   [--no-cache | --refresh-cache | --clear-cache] [--state <checkpoint>] [--perf]
+//                   [--progress-ticks N] [--progress-seconds S] [--metrics <endpoint>]
+//               --plan <file.plan> --all [--lanes N | --fork [--checkpoint N]] [--results <file.csv>]
+//                   [--metrics <endpoint>]
+//               --coordinator <endpoint> --plan <file.plan> [--workers N] [--respawn N]
+//                   [--snapshot <file>] [--results <file.csv>] [--worker-crash-after N] [--metrics <endpoint>]
+//               --worker <endpoint> [--crash-after N] [--numa-node N]
+//               --bench-placement [--rows N]
+//               --remove-shared-cache <name>
+//           any of the above with --trace <file.json> [--trace-events N]: timeline in trace-event
+//           JSON (chrome://tracing, Perfetto); a coordinator's local workers are merged in
+//           --metrics <endpoint> (unix:/path or tcp:host:port): GET /metrics (Prometheus text)
+//           and /metrics.json while the run or sweep lasts
+std::map<std::string, std::string> parse_args(int argc, char* argv[]) {
+    std::map<std::string, std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (flag.rfind("--", 0) != 0) throw std::invalid_argument("Unexpected argument: " + flag);
+        args[flag.substr(2)] = (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) ? argv[++i] : "";
+    }
+    return args;
+}
+
+void print_sweep_summary(const std::vector<SweepResult>& results, const std::string& note) {
+    auto best = std::max_element(results.begin(), results.end(),
+                                 [](const SweepResult& a, const SweepResult& b) { return a.total_pnl < b.total_pnl; });
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n==== SWEEP SUMMARY ====" << std::endl;
+    std::cout << "Runs: " << results.size() << " (" << note << ")" << std::endl;
+    if (best != results.end()) {
+        std::cout << "Best run: " << best->run_index << " P&L $" << best->total_pnl
+                  << " (" << best->total_trades << " trades)" << std::endl;
+    }
+}
+
+int run_coordinator(const std::map<std::string, std::string>& args) {
+    if (!args.count("plan")) throw std::invalid_argument("--coordinator needs --plan");
+    SweepCoordinatorOptions options;
+    options.endpoint = args.at("coordinator");
+    options.plan_path = args.at("plan");
+    if (args.count("snapshot")) options.snapshot_path = args.at("snapshot");
+    if (args.count("results")) options.results_path = args.at("results");
+    if (args.count("workers")) options.local_workers = std::stoul(args.at("workers"));
+    if (args.count("respawn")) options.max_respawns = std::stoul(args.at("respawn"));
+    if (args.count("worker-crash-after")) options.worker_args = {"--crash-after", args.at("worker-crash-after")};
+    if (args.count("trace")) options.worker_args.insert(options.worker_args.end(), {"--trace", args.at("trace")});
+
+    SweepCoordinator coordinator(options);
+    std::optional<MetricsServer> metrics;
+    if (args.count("metrics")) {
+        metrics.emplace(args.at("metrics"), [&coordinator](MetricsPage& page) {
+            add_sweep_metrics(page, coordinator.progress().load());
+        });
+    }
+    auto results = coordinator.run();
+    print_sweep_summary(results, "re-queued: " + std::to_string(coordinator.requeued_tasks()));
+    if (!options.results_path.empty()) std::cout << "Results written to " << options.results_path << std::endl;
+    std::cout << "=======================\n" << std::endl;
+    return 0;
+}
+
+// Every run of a plan in this process, sharing one copy of the data. Plans that
+// only vary simple_sma_broad parameters replay once per group of --lanes runs;
+// --fork instead resumes runs from checkpoints of a shared replay.
+int run_local_sweep(const RunPlan& plan, const std::map<std::string, std::string>& args) {
+    size_t lanes = args.count("lanes") ? std::stoul(args.at("lanes")) : SimpleSMABroadBatchStrategy::kMaxLanes;
+    lanes = std::clamp<size_t>(lanes, 1, SimpleSMABroadBatchStrategy::kMaxLanes);
+    const bool forked = args.count("fork") > 0;
+    const bool batched = !forked && lanes > 1 && plan_is_batchable(plan);
+    Logger::get().set_level(LogLevel::WARN);
+    // A node-local replica only helps if the replay stays on that node
+    if (plan.base().numa == "replicate") pin_to_numa_node(current_numa_node());
+    BacktestEngine loader;
+    loader.load_data(plan.base());
+    
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SweepResult> results;
+    // Runs here report as worker 0, as in the results CSV
+    SeqLock<SweepProgress> progress;
+    SweepProgress state;
+    state.total_runs = plan.run_count();
+    state.data_bytes = loader.get_data_store().memory_usage();
+    state.connected_workers = 1;
+    auto publish = [&](size_t recorded) {
+        for (size_t i = recorded; i < results.size(); ++i) state.record(results[i]);
+        state.pending_tasks = plan.run_count() - state.completed_runs;
+        state.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.rss_bytes = resident_bytes();
+        if (auto* self = state.worker(0)) self->busy = state.pending_tasks > 0 ? 1 : 0;
+        progress.store(state);
+    };
+    publish(0);
+    std::optional<MetricsServer> metrics;
+    if (args.count("metrics")) {
+        metrics.emplace(args.at("metrics"), [&progress](MetricsPage& page) { add_sweep_metrics(page, progress.load()); });
+    }
+    if (forked) {
+        std::vector<size_t> runs(plan.run_count());
+        for (size_t run = 0; run < runs.size(); ++run) runs[run] = run;
+        size_t checkpoint = args.count("checkpoint") ? std::stoul(args.at("checkpoint")) : 256;
+        results = run_plan_forked(plan, runs, loader.get_data_store(), std::max<size_t>(checkpoint, 1));
+        publish(0);
+    }
+    for (size_t first = forked ? plan.run_count() : 0; first < plan.run_count(); first += batched ? lanes : 1) {
+        const size_t recorded = results.size();
+        if (!batched) {
+            results.push_back(run_plan_entry(plan, first, loader.get_data_store()));
+        } else {
+            std::vector<size_t> runs;
+            for (size_t run = first; run < std::min(first + lanes, plan.run_count()); ++run) runs.push_back(run);
+            auto group = run_plan_batch(plan, runs, loader.get_data_store());
+            results.insert(results.end(), group.begin(), group.end());
+        }
+        publish(recorded);
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::ostringstream note;
+    note << (forked ? std::string("forked") : batched ? "batched, " + std::to_string(lanes) + " lanes" : std::string("one run at a time"))
+         << ", " << std::fixed << std::setprecision(2) << elapsed << "s";
+    print_sweep_summary(results, note.str());
+    if (args.count("results")) {
+        write_sweep_results(plan, results, args.at("results"));
+        std::cout << "Results written to " << args.at("results") << std::endl;
+    }
+    std::cout << "=======================\n" << std::endl;
+    return 0;
+}
+
+// Random row reads over a synthetic multi-instrument store under each memory
+// placement: time per read, how much of the data sits on huge pages, and the
+// share of pages local to the reading thread's NUMA node
+int run_placement_benchmark(const std::map<std::string, std::string>& args) {
+    const size_t rows = args.count("rows") ? std::stoul(args.at("rows")) : 4'000'000;
+    constexpr size_t kInstruments = 16;
+    constexpr size_t kReads = 20'000'000;
+    Logger::get().set_level(LogLevel::WARN);
+
+    TickDataStore base;
+    uint64_t state = 88172645463325252ull;
+    auto next = [&state] { state ^= state << 13; state ^= state >> 7; state ^= state << 17; return state; };
+    for (size_t i = 0; i < kInstruments; ++i) {
+        auto& ticks = base.get_or_create("SYN" + std::to_string(i));
+        std::vector<Timestamp> timestamps(rows / kInstruments);
+        std::vector<double> values(timestamps.size());
+        for (size_t r = 0; r < timestamps.size(); ++r) {
+            timestamps[r] = Timestamp(std::chrono::seconds(static_cast<int64_t>(r)));
+            values[r] = 100.0 + static_cast<double>(next() % 1000) / 100.0;
+        }
+        ticks.timestamps = std::move(timestamps);
+        for (auto* column : {&ticks.bid_prices, &ticks.ask_prices, &ticks.last_prices, &ticks.open,
+                             &ticks.high, &ticks.low, &ticks.close}) {
+            *column = std::vector<double>(values);
+        }
+        for (auto* column : {&ticks.bid_sizes, &ticks.ask_sizes, &ticks.volumes}) {
+            *column = std::vector<Volume>(values.size(), 100);
+        }
+        for (size_t r = 0; r < values.size(); ++r) ticks.date.push_back("");
+    }
+    pin_to_numa_node(current_numa_node());
+
+    const std::pair<const char*, MemoryPlacement> cases[] = {
+        {"heap", MemoryPlacement{}},
+        {"transparent", MemoryPlacement{HugePages::Transparent, NumaPolicy::Off}},
+        {"reserved", MemoryPlacement{HugePages::Reserved, NumaPolicy::Off}},
+        {"interleave", MemoryPlacement{HugePages::Transparent, NumaPolicy::Interleave}},
+        {"replicate", MemoryPlacement{HugePages::Transparent, NumaPolicy::Replicate}},
+    };
+    std::cout << "Placement benchmark: " << rows << " rows, " << kInstruments << " instruments, "
+              << numa_node_count() << " NUMA node(s), " << kReads << " random reads" << std::endl;
+    std::cout << std::left << std::setw(14) << "placement" << std::right << std::setw(12) << "ns/read"
+              << std::setw(14) << "dTLB/read" << std::setw(14) << "huge pages" << std::setw(12) << "local" << std::endl;
+    const PerfCounters perf;
+    for (const auto& [name, placement] : cases) {
+        TickDataStore store = base;
+        if (!placement.is_default()) TickSnapshot::place(store, placement);
+        std::vector<const TickDataStore::TickData*> columns;
+        for (size_t i = 0; i < kInstruments; ++i) columns.push_back(store.get_ticks("SYN" + std::to_string(i)));
+        const size_t per_instrument = columns[0]->size();
+
+        double sum = 0.0;
+        const auto counts_before = perf.read();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t read = 0; read < kReads; ++read) {
+            const uint64_t r = next();
+            const auto& ticks = *columns[r % kInstruments];
+            const size_t row = (r >> 8) % per_instrument;
+            sum += ticks.close[row] + ticks.high[row] - ticks.low[row] + ticks.volumes[row];
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        const auto counts = perf.read() - counts_before;
+        volatile double sink = sum;  // Keep the reads
+        (void)sink;
+
+        const auto& first = *columns[0];
+        const size_t bytes = TickSnapshot::encoded_size(store);
+        const double huge_share = static_cast<double>(huge_page_bytes(first.close.data())) / static_cast<double>(bytes);
+        std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << ns / kReads;
+        if (perf.has(PerfCounters::DTLBMisses)) {
+            std::cout << std::setw(14) << static_cast<double>(counts[PerfCounters::DTLBMisses]) / kReads;
+        } else {
+            std::cout << std::setw(14) << "n/a";
+        }
+        std::cout << std::setw(13) << std::min(huge_share, 1.0) * 100 << '%'
+                  << std::setw(11) << local_page_fraction(first.close.data(), per_instrument * sizeof(double)) * 100
+                  << '%' << std::endl;
+    }
+    return 0;
+}
+
+int run_from_args(const std::map<std::string, std::string>& args) {
+    if (args.count("remove-shared-cache")) {
+        const std::string& name = args.at("remove-shared-cache");
+        const int32_t refs = SharedTickCache::reference_count(name);
+        if (refs < 0) {
+            std::cout << "Shared cache " << name << " is not published" << std::endl;
+            return 0;
+        }
+        SharedTickCache::remove(name);
+        std::cout << "Removed shared cache " << name << " (" << refs << " references)" << std::endl;
+        return 0;
+    }
+    if (args.count("bench-placement")) return run_placement_benchmark(args);
+    if (args.count("coordinator")) return run_coordinator(args);
+    if (args.count("worker")) {
+        Logger::get().set_level(LogLevel::WARN);
+        SweepWorkerOptions options;
+        options.endpoint = args.at("worker");
+        if (args.count("crash-after")) options.crash_after = std::stoul(args.at("crash-after"));
+        if (args.count("numa-node")) options.numa_node = std::stoi(args.at("numa-node"));
+        return run_sweep_worker(options);
+    }
+    size_t run = args.count("run") ? std::stoul(args.at("run")) : 0;
+    if (args.count("plan")) {
+        RunPlan plan = RunPlan::load(args.at("plan"));
+        if (args.count("all")) return run_local_sweep(plan, args);
+        Config config = plan.config_for(run);
+        print_engine_results(config, run_configured(config, args));
+        return 0;
+    }
+    Config config = Config::load_file(args.at("config"));
+    RunPlan plan = RunPlan::compile(config);
+    if (args.count("compile-plan")) {
+        plan.save(args.at("compile-plan"));
+        std::cout << "Run plan written to " << args.at("compile-plan") << " ("
+                  << plan.run_count() << " runs, " << plan.param_count() << " swept parameters)" << std::endl;
+        return 0;
+    }
+    if (args.count("write-archive")) {
+        BacktestEngine loader;
+        loader.load_data(config);
+        const size_t block_rows = args.count("block-rows") ? std::stoul(args.at("block-rows")) : TickArchive::kDefaultBlockRows;
+        const size_t partitions = TickArchive::write(loader.get_data_store(), args.at("write-archive"), block_rows);
+        std::cout << "Tick archive written to " << args.at("write-archive") << " (" << partitions << " partitions)" << std::endl;
+        return 0;
+    }
+    Config resolved = plan.config_for(run);
+    print_engine_results(resolved, run_configured(resolved, args));
+    return 0;
+}
+
+} // namespace
+
 int main(int argc, char* argv[]) {
     try {
         // Initialize logging
@@ -19,6 +448,24 @@ int main(int argc, char* argv[]) {
         Logger::get().start();
         Logger& logger = Logger::get();
 
+        auto args = parse_args(argc, argv);
+        if (args.count("config") || args.count("plan") || args.count("worker") || args.count("bench-placement") ||
+            args.count("remove-shared-cache")) {
+            if (args.count("trace")) {
+                Trace::start(args.count("trace-events") ? std::stoul(args.at("trace-events")) : Trace::kDefaultEvents);
+                Trace::set_thread_name(args.count("worker") ? "sweep worker" : args.count("coordinator") ? "coordinator" : "main");
+            }
+            int rc = run_from_args(args);
+            if (args.count("trace") && args.count("worker")) {
+                Trace::write_fragment(args.at("trace"));
+            } else if (args.count("trace")) {
+                Trace::write_json(args.at("trace"));
+                std::cout << "Trace written to " << args.at("trace") << std::endl;
+            }
+            Logger::get().stop();
+            return rc;
+        }
+
         // Example: Load multiple CSVs dynamically
         std::map<std::string, std::vector<DataPoint>> datasets;
         DataLoader loader;
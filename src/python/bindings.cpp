@@ -1,20 +1,151 @@
 #include "python/bindings.h"
+#include "utils/config.h"
+#include "utils/time_utils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
 
 namespace backtest {
 namespace python {
 
+namespace {
+    // Live Python strategies by id, so the API can reach them from Python
+    std::mutex registry_mutex;
+    std::unordered_map<StrategyId, PythonStrategy*> strategy_registry;
+
+    // Configuration shared by the Python API
+    Config& api_config() {
+        static Config config;
+        return config;
+    }
+
+    // Engine driven by the Python API; it owns the strategies added through it
+    std::unique_ptr<BacktestEngine>& api_engine() {
+        static std::unique_ptr<BacktestEngine> engine = std::make_unique<BacktestEngine>();
+        return engine;
+    }
+
+    PythonStrategy* find_strategy(const StrategyId& strategy_id) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        auto it = strategy_registry.find(strategy_id);
+        return (it != strategy_registry.end()) ? it->second : nullptr;
+    }
+
+    int64_t signed_quantity(const Position* position) {
+        return position ? static_cast<int64_t>(position->quantity) : 0;
+    }
+}
+
 PythonStrategy::PythonStrategy(const StrategyId& strategy_id, const std::string& python_module)
     : StrategyBase(strategy_id), python_module_(python_module) {
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        strategy_registry[strategy_id] = this;
+    }
     Logger::get().info("python", "PythonStrategy constructed for module: " + python_module);
 }
 
+PythonStrategy::~PythonStrategy() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = strategy_registry.find(strategy_id_);
+    if (it != strategy_registry.end() && it->second == this) {
+        strategy_registry.erase(it);
+    }
+}
+
 void PythonStrategy::initialize() {
     Logger::get().info("python", "PythonStrategy::initialize called");
+    native_states_.clear();
 }
 void PythonStrategy::on_market_data(const MarketEvent& event) {
-    Logger::get().info("python", "PythonStrategy::on_market_data called");
+    if (native_callback_) {
+        dispatch_native(event.tick());
+        return;
+    }
+    const auto& tick = event.tick();
+    call_python_method("on_market_data", {tick.instrument, tick.date,
+                                          std::to_string(tick.bid_price),
+                                          std::to_string(tick.ask_price),
+                                          std::to_string(tick.last_price)});
 }
+
+void PythonStrategy::set_native_callback(NemoTickCallback callback, size_t state_slots) {
+    native_callback_ = callback;
+    native_state_slots_ = state_slots;
+    native_states_.clear();
+    Logger::get().info("python", "Native callback attached for strategy: " + strategy_id_);
+}
+
+void PythonStrategy::clear_native_callback() {
+    set_native_callback(nullptr, 0);
+}
+
+void PythonStrategy::dispatch_native(const MarketDataTick& tick) {
+    const size_t index = current_slot();
+    while (native_states_.size() <= index) {
+        native_states_.emplace_back().user_state.assign(native_state_slots_, 0.0);
+    }
+    auto& slot = native_states_[index];
+    
+    // Re-point scratch every call: emplace_back may have moved earlier slots
+    slot.state.user_state = slot.user_state.empty() ? nullptr : slot.user_state.data();
+    slot.state.user_state_len = static_cast<uint32_t>(slot.user_state.size());
+    if (const Position* pos = get_position(tick.instrument)) {
+        slot.state.position = static_cast<double>(static_cast<int64_t>(pos->quantity));
+        slot.state.average_price = pos->average_price;
+    }
+    
+    NemoNativeTick native_tick{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(tick.timestamp.time_since_epoch()).count(),
+        tick.bid_price, tick.ask_price, tick.last_price,
+        tick.open, tick.high, tick.low, tick.close,
+        tick.volume, static_cast<uint32_t>(index), 0
+    };
+    
+    auto action = static_cast<NativeAction>(native_callback_(&native_tick, &slot.state));
+    ++slot.state.tick_count;
+    
+    switch (action) {
+        case NativeAction::BUY: trade(tick.instrument, Side::BUY, 1); break;
+        case NativeAction::SELL: trade(tick.instrument, Side::SELL, 1); break;
+        case NativeAction::CLOSE: {
+            const int64_t held = signed_quantity(get_position(tick.instrument));
+            if (held != 0) trade(tick.instrument, held > 0 ? Side::SELL : Side::BUY, static_cast<Volume>(std::abs(held)));
+            break;
+        }
+        case NativeAction::HOLD: break;
+    }
+}
+
+void PythonStrategy::trade(const InstrumentId& instrument, Side side, Volume quantity) {
+    const Price price = market_price(Field::Close);
+    const int64_t held = signed_quantity(get_position(instrument));
+    const Price average = held != 0 ? get_position(instrument)->average_price : 0.0;
+    const int64_t delta = side == Side::BUY ? static_cast<int64_t>(quantity) : -static_cast<int64_t>(quantity);
+    const int64_t after = held + delta;
+    
+    // The part that reduces the position realizes its P&L against the average price
+    if (held != 0 && (held > 0) != (delta > 0)) {
+        const int64_t closed = std::min(std::abs(held), std::abs(delta));
+        realized_pnl_ += (price - average) * static_cast<Price>(held > 0 ? closed : -closed);
+        total_pnl_ = realized_pnl_;
+    }
+    execute_order(instrument, side, price, quantity);
+    
+    Position& position = positions_[instrument];
+    position.instrument = instrument;
+    position.strategy = strategy_id_;
+    if (after == 0) position.average_price = 0.0;
+    else if (held == 0 || (held > 0) != (after > 0)) position.average_price = price;
+    else if (std::abs(after) > std::abs(held)) {
+        position.average_price = (average * static_cast<Price>(std::abs(held)) + price * static_cast<Price>(quantity)) /
+                                 static_cast<Price>(std::abs(after));
+    } else position.average_price = average;
+}
+
 void PythonStrategy::on_fill(const FillEvent& event) {
     Logger::get().info("python", "PythonStrategy::on_fill called");
 }
@@ -33,25 +164,64 @@ namespace api {
 
 void initialize_engine(const std::string& config_file) {
     Logger::get().info("python_api", "initialize_engine called");
+    api_config() = config_file.empty() ? Config{} : Config::load_file(config_file);
+    // Dropping the old engine unregisters its strategies
+    api_engine() = std::make_unique<BacktestEngine>();
+    if (!config_file.empty()) api_engine()->configure(api_config());
 }
 void add_strategy_from_python(const std::string& strategy_id, const std::string& module_name) {
-    Logger::get().info("python_api", "add_strategy_from_python called");
-}
+    if (find_strategy(strategy_id)) throw std::invalid_argument("Strategy already added: " + strategy_id);
+    api_engine()->add_strategy(std::make_unique<PythonStrategy>(strategy_id, module_name));
+}
+void attach_native_callback(const std::string& strategy_id, uintptr_t callback_address, size_t state_slots) {
+    auto* strategy = find_strategy(strategy_id);
+    if (!strategy) {
+        Logger::get().error("python_api", "attach_native_callback: unknown strategy " + strategy_id);
+        return;
+    }
+    if (callback_address == 0) {
+        Logger::get().error("python_api", "attach_native_callback: null callback for " + strategy_id);
+        return;
+    }
+    strategy->set_native_callback(reinterpret_cast<NemoTickCallback>(callback_address), state_slots);
+}
+void detach_native_callback(const std::string& strategy_id) {
+    if (auto* strategy = find_strategy(strategy_id)) {
+        strategy->clear_native_callback();
+    }
+}
+int native_abi_version() { return NEMO_NATIVE_ABI_VERSION; }
 void load_data_file(const std::string& filepath) {
-    Logger::get().info("python_api", "load_data_file called");
+    // Instrument of the matching [data] entry, else the file name
+    InstrumentId instrument = std::filesystem::path(filepath).stem().string();
+    for (const auto& source : api_config().data) {
+        if (source.path == filepath) instrument = source.instrument;
+    }
+    api_engine()->load_data(filepath, instrument);
 }
 void run_backtest() {
-    Logger::get().info("python_api", "run_backtest called");
+    api_engine()->run();
 }
 void run_backtest_range(const std::string& start_date, const std::string& end_date) {
-    Logger::get().info("python_api", "run_backtest_range called");
+    int64_t start_ns = 0;
+    int64_t end_ns = 0;
+    if (!TimeUtils::parse_timestamp(start_date, start_ns) || !TimeUtils::parse_timestamp(end_date, end_ns)) {
+        throw std::invalid_argument("Unparseable range: " + start_date + " to " + end_date);
+    }
+    api_engine()->run_range(TimeUtils::from_epoch_ns(start_ns), TimeUtils::from_epoch_ns(end_ns));
 }
 std::vector<double> get_prices(const std::string& instrument) { Logger::get().info("python_api", "get_prices called"); return {}; }
 std::vector<std::string> get_timestamps(const std::string& instrument) { Logger::get().info("python_api", "get_timestamps called"); return {}; }
 size_t get_data_size(const std::string& instrument) { Logger::get().info("python_api", "get_data_size called"); return 0; }
-double get_position(const std::string& strategy_id, const std::string& instrument) { Logger::get().info("python_api", "get_position called"); return 0.0; }
-double get_strategy_pnl(const std::string& strategy_id) { Logger::get().info("python_api", "get_strategy_pnl called"); return 0.0; }
-double get_total_pnl() { Logger::get().info("python_api", "get_total_pnl called"); return 0.0; }
+double get_position(const std::string& strategy_id, const std::string& instrument) {
+    const auto* strategy = find_strategy(strategy_id);
+    return strategy ? static_cast<double>(signed_quantity(strategy->get_position(instrument))) : 0.0;
+}
+double get_strategy_pnl(const std::string& strategy_id) {
+    const auto* strategy = find_strategy(strategy_id);
+    return strategy ? strategy->get_total_pnl() : 0.0;
+}
+double get_total_pnl() { return api_engine()->get_results().total_pnl; }
 void submit_buy_order(const std::string& strategy_id, const std::string& instrument, double quantity, double price) { Logger::get().info("python_api", "submit_buy_order called"); }
 void submit_sell_order(const std::string& strategy_id, const std::string& instrument, double quantity, double price) { Logger::get().info("python_api", "submit_sell_order called"); }
 void emit_buy_signal(const std::string& strategy_id, const std::string& instrument, double strength) { Logger::get().info("python_api", "emit_buy_signal called"); }
@@ -62,6 +232,10 @@ void export_results(const std::string& output_dir) {
 }
 void set_config_value(const std::string& key, const std::string& value) {
     Logger::get().info("python_api", "set_config_value: " + key + " = " + value);
+    api_config().set_value(key, value);
+}
+std::string get_config_value(const std::string& key) {
+    return api_config().get_value(key);
 }
 void log_debug(const std::string& strategy_id, const std::string& message) {
     Logger::get().debug("python_api", "[" + strategy_id + "] " + message);
@@ -0,0 +1,32 @@
+#include "strategy/channel_breakout.h"
+#include <algorithm>
+
+namespace backtest {
+
+CoroutineStrategy::Task ChannelBreakoutStrategy::run(size_t) {
+    for (;;) {
+        // Flat: wait for a close above the channel of the bars before this one
+        const MarketDataTick& setup = co_await next_bar();
+        auto highs = history(Field::High, lookback_ + 1);
+        if (highs.size() <= lookback_ || setup.close <= *std::max_element(highs.begin(), highs.end() - 1)) continue;
+        const Fill entry = co_await fill(Side::BUY, setup.close, quantity_);
+
+        // Long: hold until a close below the channel
+        Price exit_price = entry.price;
+        for (;;) {
+            const MarketDataTick& held = co_await next_bar();
+            auto lows = history(Field::Low, lookback_ + 1);
+            if (held.close < *std::min_element(lows.begin(), lows.end() - 1)) {
+                exit_price = held.close;
+                break;
+            }
+        }
+        const Fill exit = co_await fill(Side::SELL, exit_price, entry.quantity);
+        realized_pnl_ += (exit.price - entry.price) * static_cast<Price>(exit.quantity);
+        total_pnl_ = realized_pnl_;
+
+        co_await timer(cooldown_);
+    }
+}
+
+} // namespace backtest
@@ -0,0 +1,35 @@
+#include "strategy/coroutine_strategy.h"
+#include "utils/time_utils.h"
+
+namespace backtest {
+
+void CoroutineStrategy::initialize() {
+    lanes_.clear();
+    lanes_.resize(slot_count());
+    for (size_t slot = 0; slot < lanes_.size(); ++slot) {
+        current_slot_ = slot;
+        lanes_[slot].task = run(slot);
+        lanes_[slot].task.resume();
+    }
+}
+
+void CoroutineStrategy::on_market_data(const MarketEvent& event) {
+    auto& lane = lanes_[current_slot()];
+    if (lane.task.done() || TimeUtils::to_epoch_ns(event.tick().timestamp) < lane.wake_ns) return;
+    bar_ = &event.tick();
+    lane.task.resume();
+    bar_ = nullptr;
+}
+
+CoroutineStrategy::BarAwaiter CoroutineStrategy::timer(Duration delay) {
+    if (!bar_) return next_bar();
+    return BarAwaiter{this, TimeUtils::to_epoch_ns(bar_->timestamp) + delay.count()};
+}
+
+Fill CoroutineStrategy::place(Side side, Price price, Volume quantity) {
+    const InstrumentId& instrument = slot_instrument(current_slot());
+    const OrderId id = execute_order(instrument, side, price, quantity);
+    return Fill(id, bar_ ? bar_->timestamp : Timestamp{}, instrument, strategy_id_, side, price, quantity);
+}
+
+} // namespace backtest
@@ -1,5 +1,6 @@
 #include "strategy/simple_sma_broad.h"
 #include "utils/logging.h"
+#include "calendar/trading_calendar.h"
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -14,19 +15,22 @@ namespace backtest {
 
 // Helper functions for indicators (EMA, RSI, ATR, ADX, etc.)
 namespace {
-    double ema(const std::vector<double>& data, int period, int idx) {
-        if (idx < period - 1) return NAN;
+    // All helpers evaluate at the newest element of data
+    double ema(std::span<const double> data, int period) {
+        const size_t n = data.size();
+        if (n < static_cast<size_t>(period)) return NAN;
         double k = 2.0 / (period + 1);
-        double ema_val = data[idx - period + 1];
-        for (int i = idx - period + 2; i <= idx; ++i) {
+        double ema_val = data[n - period];
+        for (size_t i = n - period + 1; i < n; ++i) {
             ema_val = data[i] * k + ema_val * (1 - k);
         }
         return ema_val;
     }
-    double rsi(const std::vector<double>& close, int period, int idx) {
-        if (idx < period) return NAN;
+    double rsi(std::span<const double> close, int period) {
+        const size_t n = close.size();
+        if (n < static_cast<size_t>(period) + 1) return NAN;
         double gain = 0, loss = 0;
-        for (int i = idx - period + 1; i <= idx; ++i) {
+        for (size_t i = n - period; i < n; ++i) {
             double delta = close[i] - close[i - 1];
             if (delta > 0) gain += delta;
             else loss -= delta;
@@ -35,10 +39,12 @@ namespace {
         double rs = gain / (loss == 0 ? 1e-10 : loss);
         return 100 - (100 / (1 + rs));
     }
-    double rolling_mean(const std::vector<double>& data, int period, int idx) {
-        if (idx < period - 1) return NAN;
+    template <typename T>
+    double rolling_mean(std::span<const T> data, int period) {
+        const size_t n = data.size();
+        if (n < static_cast<size_t>(period)) return NAN;
         double sum = 0;
-        for (int i = idx - period + 1; i <= idx; ++i) sum += data[i];
+        for (size_t i = n - period; i < n; ++i) sum += static_cast<double>(data[i]);
         return sum / period;
     }
 }
@@ -70,13 +76,27 @@ SimpleSMABroadStrategy::SimpleSMABroadStrategy(const StrategyId& id,
     log_path = "logs/simpleSMABroad_trades.log";
     last_date = "";
     print_count_m = 0; // Initialize debug print counter
+    close_window_ = static_cast<size_t>(std::max({short_ema, long_ema, rsi_period + 1, 2}));
+    tr_hist_m.set_capacity(std::max(atr_period, adx_period));
+    plus_dm_hist_m.set_capacity(adx_period);
+    minus_dm_hist_m.set_capacity(adx_period);
+    dx_hist_m.set_capacity(adx_period);
+    set_session(SessionSpec::parse("09:15-15:30")); // Engine skips ticks outside market hours
 }
 
 void SimpleSMABroadStrategy::initialize() {
+    equity = initial_capital;
+    daily_peak = equity;
+    sessions_driven_ = false;
+    rsi_lb_range_ = rsi_ub_range_ = adx_range_ = ThresholdRange{};
+    sized_trade_ = checked_drawdown_ = false;
+    position = 0;
+    entry_price = stop_level = tp_level = original_stop_distance = 0.0;
+    realized_pnl_ = total_pnl_ = 0.0;
+    trade_count_ = 0;
     trade_logs.clear();
-    std::ofstream(log_path, std::ios::trunc); // clear log file
-    close.clear(); high.clear(); low.clear(); volume.clear(); datetime.clear();
-    // Clear indicator history vectors
+    if (!log_path.empty()) std::ofstream(log_path, std::ios::trunc); // clear log file
+    // Clear indicator history
     tr_hist_m.clear();
     plus_dm_hist_m.clear();
     minus_dm_hist_m.clear();
@@ -84,15 +104,8 @@ void SimpleSMABroadStrategy::initialize() {
     print_count_m = 0; // Reset debug print counter on initialize
 }
 
-void SimpleSMABroadStrategy::on_market_data(const MarketEvent& event) {
-    const auto& tick = event.tick();
-    // Use correct fields from MarketDataTick
-    close.push_back(tick.close);
-    high.push_back(tick.high);
-    low.push_back(tick.low);
-    volume.push_back(tick.volume);
-    datetime.push_back(tick.date);
-    int idx = close.size() - 1;
+int SimpleSMABroadStrategy::begin_bar(const MarketDataTick& tick) {
+    int idx = static_cast<int>(history_length()) - 1;
 
     if (print_count_m < 5) {
         std::cout << "[TICK] idx=" << idx
@@ -115,28 +128,48 @@ void SimpleSMABroadStrategy::on_market_data(const MarketEvent& event) {
         plus_dm_hist_m.push_back(0);
         minus_dm_hist_m.push_back(0);
         dx_hist_m.push_back(0);
-        return; 
     }
+    return idx;
+}
 
-    if (datetime[idx].size() < 16) return; // Defensive: skip if not enough chars for time
-    std::string tstr = datetime[idx].substr(11, 5);
-    if (tstr < "09:15" || tstr > "15:30") return;
+void SimpleSMABroadStrategy::on_warmup_data(const MarketEvent& event) {
+    begin_bar(event.tick());
+}
+
+void SimpleSMABroadStrategy::on_timer(const TimerEvent& event) {
+    if (event.timer_id() != kSessionStartTimer) return;
+    // New trading day: drawdown is measured from the opening equity
+    daily_peak = equity;
+    sessions_driven_ = true;
+}
+
+void SimpleSMABroadStrategy::on_market_data(const MarketEvent& event) {
+    const MarketDataTick& tick = event.tick();
+    int idx = begin_bar(tick);
+    if (idx == 0) return;
+    // Session filtering happens in the engine (see set_session in the constructor)
+    // Views into the data store ending at this bar; [n - 1] is the current bar
+    auto close = history(Field::Close, close_window_);
+    auto high = history(Field::High, 2);
+    auto low = history(Field::Low, 2);
+    auto volume = volume_history(20);
+    const size_t n = close.size();
     // Indicators
-    double ema_short = ema(close, short_ema, idx);
-    double ema_long = ema(close, long_ema, idx);
-    double rsi_val = rsi(close, rsi_period, idx);
-    double vol_ma20 = rolling_mean(volume, 20, idx);
+    double ema_short = ema(close, short_ema);
+    double ema_long = ema(close, long_ema);
+    double rsi_val = rsi(close, rsi_period);
+    double vol_ma20 = rolling_mean(volume, 20);
     // ATR
-    double hl = high[idx] - low[idx];
-    double hc = std::abs(high[idx] - close[idx - 1]);
-    double lc = std::abs(low[idx] - close[idx - 1]);
+    double hl = high[1] - low[1];
+    double hc = std::abs(high[1] - close[n - 2]);
+    double lc = std::abs(low[1] - close[n - 2]);
     double tr = std::max({hl, hc, lc});
     tr_hist_m.push_back(tr);
-    double atr = ema(tr_hist_m, atr_period, tr_hist_m.size() - 1);
+    double atr = ema(tr_hist_m.view(), atr_period);
 
     // ADX (simplified for demo)
-    double up = high[idx] - high[idx - 1];
-    double dn = low[idx - 1] - low[idx];
+    double up = high[1] - high[0];
+    double dn = low[0] - low[1];
     double plus_dm = (up > dn && up > 0) ? up : 0;
     double minus_dm = (dn > up && dn > 0) ? dn : 0;
     
@@ -150,63 +183,160 @@ void SimpleSMABroadStrategy::on_market_data(const MarketEvent& event) {
         return; 
     }
     // We need to ensure that the index for tr_hist_m in ema calculation is valid
-    double current_tr_ema = ema(tr_hist_m, adx_period, tr_hist_m.size() - 1);
+    double current_tr_ema = ema(tr_hist_m.view(), adx_period);
     if (std::isnan(current_tr_ema)) { // Not enough data for TR EMA
         dx_hist_m.push_back(0); // Cannot calculate DX, push placeholder
         // adx will also be NAN or based on insufficient data
     } else {
-        double plus_di = 100 * (ema(plus_dm_hist_m, adx_period, plus_dm_hist_m.size() -1) / (current_tr_ema == 0 ? 1e-10 : current_tr_ema));
-        double minus_di = 100 * (ema(minus_dm_hist_m, adx_period, minus_dm_hist_m.size() -1) / (current_tr_ema == 0 ? 1e-10 : current_tr_ema));
+        double plus_di = 100 * (ema(plus_dm_hist_m.view(), adx_period) / (current_tr_ema == 0 ? 1e-10 : current_tr_ema));
+        double minus_di = 100 * (ema(minus_dm_hist_m.view(), adx_period) / (current_tr_ema == 0 ? 1e-10 : current_tr_ema));
         double dx_val = (plus_di + minus_di == 0) ? 0 : (100 * (std::abs(plus_di - minus_di) / (plus_di + minus_di)));
         dx_hist_m.push_back(dx_val);
     }
 
-    double adx = ema(dx_hist_m, adx_period, dx_hist_m.size() - 1);
+    double adx = ema(dx_hist_m.view(), adx_period);
 
     // Trading logic
     if (position == 0) {
         // Entry condition
-        if (idx > 0 && ema_short > ema_long && close[idx - 1] <= ema_long &&
-            rsi_lb < rsi_val && rsi_val < rsi_ub && adx > adx_threshold && volume[idx] > vol_ma20) {
+        bool halted = sessions_driven_ && equity < daily_peak * (1 - max_daily_drawdown);
+        checked_drawdown_ = checked_drawdown_ || sessions_driven_;
+        // Conditions evaluated one at a time so forks know which thresholds were consulted
+        bool enter = !halted && ema_short > ema_long && close[n - 2] <= ema_long;
+        if (enter) {
+            rsi_lb_range_.observe(rsi_val, rsi_lb);
+            enter = rsi_lb < rsi_val;
+        }
+        if (enter) {
+            rsi_ub_range_.observe(-rsi_val, -rsi_ub);
+            enter = rsi_val < rsi_ub;
+        }
+        if (enter) {
+            adx_range_.observe(adx, adx_threshold);
+            enter = adx > adx_threshold;
+        }
+        if (enter && volume.back() > vol_ma20) {
+            sized_trade_ = true;
             double risk_amt = equity * risk_per_trade;
-            double stop = close[idx] - atr;
-            int qty = static_cast<int>(risk_amt / (close[idx] - stop));
+            double stop = tick.close - atr;
+            int qty = static_cast<int>(risk_amt / (tick.close - stop));
             if (qty >= 1) {
-                entry_price = close[idx] * (1 + slippage);
+                entry_price = tick.close * (1 + slippage);
                 tp_level = entry_price + 1.5 * atr;
                 stop_level = entry_price - (entry_price - stop);
                 original_stop_distance = entry_price - stop_level;
                 position = qty;
                 // Log entry
                 std::ostringstream oss;
-                oss << "ENTRY," << datetime[idx] << "," << entry_price << "," << qty << ",EQUITY," << equity;
+                oss << "ENTRY," << tick.date << "," << entry_price << "," << qty << ",EQUITY," << equity;
                 log_trade(oss.str());
             }
         }
     } else {
-        bool is_heavy_loss = close[idx] < entry_price - 2 * atr;
+        bool is_heavy_loss = tick.close < entry_price - 2 * atr;
         if (is_heavy_loss) stop_level = entry_price - 1.5 * original_stop_distance;
+        // A bar through both levels exits at the stop unless finer data shows the target came first
+        bool stop_hit = tick.low <= stop_level;
+        const bool target_hit = tick.high >= tp_level;
+        if (stop_hit && target_hit) stop_hit = first_touch(stop_level, tp_level) != Touch::High;
         double exit_price = NAN;
-        if (low[idx] <= stop_level) exit_price = stop_level;
-        else if (high[idx] >= tp_level) exit_price = tp_level;
-        else if (!is_heavy_loss && close[idx] > entry_price) exit_price = close[idx] * (1 - slippage);
+        if (stop_hit) exit_price = stop_level;
+        else if (target_hit) exit_price = tp_level;
+        else if (!is_heavy_loss && tick.close > entry_price) exit_price = tick.close * (1 - slippage);
         if (!std::isnan(exit_price)) {
             double profit = (exit_price - entry_price) * position;
             double commission = 20 * 2 + (profit > 0 ? 0.01 * profit : 0);
             double net_pnl = profit - commission;
             equity += net_pnl;
+            realized_pnl_ += net_pnl;
+            total_pnl_ = realized_pnl_;
+            ++trade_count_;
             std::ostringstream oss;
-            oss << "EXIT," << datetime[idx] << "," << exit_price << "," << position << ",PROFIT," << profit << ",COMMISSION," << commission << ",NET_PNL," << net_pnl << ",EQUITY," << equity;
+            oss << "EXIT," << tick.date << "," << exit_price << "," << position << ",PROFIT," << profit << ",COMMISSION," << commission << ",NET_PNL," << net_pnl << ",EQUITY," << equity;
             log_trade(oss.str());
             position = 0;
             entry_price = stop_level = tp_level = original_stop_distance = 0.0;
+            daily_peak = std::max(daily_peak, equity);
         }
     }
 }
 
+bool SimpleSMABroadStrategy::set_parameter(const std::string& name, double value) {
+    if (name == "rsi_lb") rsi_lb = value;
+    else if (name == "rsi_ub") rsi_ub = value;
+    else if (name == "adx_threshold") adx_threshold = value;
+    else if (name == "risk_per_trade") risk_per_trade = value;
+    else if (name == "slippage") slippage = value;
+    else if (name == "max_daily_drawdown") max_daily_drawdown = value;
+    else return false;
+    return true;
+}
+
+bool SimpleSMABroadStrategy::parameter_agrees(const std::string& name, double value) const {
+    if (name == "rsi_lb") return rsi_lb_range_.contains(value);
+    if (name == "rsi_ub") return rsi_ub_range_.contains(-value);
+    if (name == "adx_threshold") return adx_range_.contains(value);
+    if (name == "risk_per_trade") return !sized_trade_ || value == risk_per_trade;
+    if (name == "slippage") return !sized_trade_ || value == slippage;
+    if (name == "max_daily_drawdown") return !checked_drawdown_ || value == max_daily_drawdown;
+    return false;
+}
+
+void SimpleSMABroadStrategy::save_state(BinaryWriter& out) const {
+    save_base_state(out);
+    out.pod(equity);
+    out.pod(daily_peak);
+    out.pod(sessions_driven_);
+    out.pod(position);
+    out.pod(entry_price);
+    out.pod(stop_level);
+    out.pod(tp_level);
+    out.pod(original_stop_distance);
+    out.pod(print_count_m);
+    for (const auto* window : {&tr_hist_m, &plus_dm_hist_m, &minus_dm_hist_m, &dx_hist_m}) {
+        auto values = window->view();
+        out.vec(std::vector<double>(values.begin(), values.end()));
+    }
+    for (const auto& range : {rsi_lb_range_, rsi_ub_range_, adx_range_}) {
+        out.pod(range.lo);
+        out.pod(range.hi);
+    }
+    out.pod(sized_trade_);
+    out.pod(checked_drawdown_);
+}
+
+void SimpleSMABroadStrategy::load_state(BinaryReader& in) {
+    load_base_state(in);
+    equity = in.pod<double>();
+    daily_peak = in.pod<double>();
+    sessions_driven_ = in.pod<bool>();
+    position = in.pod<int>();
+    entry_price = in.pod<double>();
+    stop_level = in.pod<double>();
+    tp_level = in.pod<double>();
+    original_stop_distance = in.pod<double>();
+    print_count_m = in.pod<int>();
+    for (auto* window : {&tr_hist_m, &plus_dm_hist_m, &minus_dm_hist_m, &dx_hist_m}) {
+        window->clear();
+        for (double value : in.vec<double>()) window->push_back(value);
+    }
+    for (auto* range : {&rsi_lb_range_, &rsi_ub_range_, &adx_range_}) {
+        range->lo = in.pod<double>();
+        range->hi = in.pod<double>();
+    }
+    sized_trade_ = in.pod<bool>();
+    checked_drawdown_ = in.pod<bool>();
+    trade_logs.clear();  // The trade log file keeps the earlier runs' lines
+}
+
+void SimpleSMABroadStrategy::on_stop() {
+    flush_logs();
+}
+
 void SimpleSMABroadStrategy::on_fill(const FillEvent&) {}
 
 void SimpleSMABroadStrategy::log_trade(const std::string& log_line) {
+    if (log_path.empty()) return; // trade logging disabled
     trade_logs.push_back(log_line);
     if (trade_logs.size() >= 100) flush_logs();
 }
@@ -0,0 +1,269 @@
+#include "strategy/simple_sma_broad_batch.h"
+#include "calendar/trading_calendar.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace backtest {
+
+namespace {
+
+// EMA seeded at data[n - period] and evaluated at the newest element, for
+// every lane at once. Lanes whose period exceeds the data come out NaN.
+void lane_ema(std::span<const double> data, const std::vector<int>& period,
+              const std::vector<double>& k, std::vector<double>& out) {
+    const size_t lanes = period.size();
+    const int64_t n = static_cast<int64_t>(data.size());
+    const int64_t longest = *std::max_element(period.begin(), period.end());
+    std::fill(out.begin(), out.end(), NAN);
+    for (int64_t s = std::max<int64_t>(0, n - longest); s < n; ++s) {
+        const double v = data[s];
+        for (size_t l = 0; l < lanes; ++l) {
+            const int64_t start = n - period[l];
+            const double next = v * k[l] + out[l] * (1 - k[l]);
+            out[l] = (s == start) ? v : (s > start ? next : out[l]);
+        }
+    }
+}
+
+template <typename T>
+double rolling_mean(std::span<const T> data, int period) {
+    const size_t n = data.size();
+    if (n < static_cast<size_t>(period)) return NAN;
+    double sum = 0;
+    for (size_t i = n - period; i < n; ++i) sum += static_cast<double>(data[i]);
+    return sum / period;
+}
+
+std::vector<double> smoothing(const std::vector<int>& period) {
+    std::vector<double> k(period.size());
+    for (size_t l = 0; l < period.size(); ++l) k[l] = 2.0 / (period[l] + 1);
+    return k;
+}
+
+} // namespace
+
+SimpleSMABroadBatchStrategy::SimpleSMABroadBatchStrategy(const StrategyId& id)
+    : StrategyBase(id) {
+    set_session(SessionSpec::parse("09:15-15:30"));  // Same default as the scalar strategy
+}
+
+size_t SimpleSMABroadBatchStrategy::add_lane(const Config& run_config) {
+    if (lane_count() == kMaxLanes) throw std::length_error("Batch already holds " + std::to_string(kMaxLanes) + " lanes");
+    const auto& config = run_config.strategy;
+    auto p = [&config](const char* name, double fallback) { return config.param(name, fallback); };
+    short_ema_.push_back(static_cast<int>(p("short_ema", 9)));
+    long_ema_.push_back(static_cast<int>(p("long_ema", 21)));
+    rsi_period_.push_back(static_cast<int>(p("rsi_period", 14)));
+    rsi_lb_.push_back(p("rsi_lb", 40.0));
+    rsi_ub_.push_back(p("rsi_ub", 70.0));
+    atr_period_.push_back(static_cast<int>(p("atr_period", 14)));
+    adx_period_.push_back(static_cast<int>(p("adx_period", 14)));
+    adx_threshold_.push_back(p("adx_threshold", 20.0));
+    risk_per_trade_.push_back(p("risk_per_trade", 0.01));
+    initial_capital_.push_back(run_config.initial_capital);
+    slippage_.push_back(p("slippage", 0.0005));
+    max_daily_drawdown_.push_back(p("max_daily_drawdown", 0.03));
+    return lane_count() - 1;
+}
+
+void SimpleSMABroadBatchStrategy::initialize() {
+    const size_t lanes = lane_count();
+    if (lanes == 0) throw std::logic_error("SimpleSMABroadBatchStrategy has no lanes");
+    k_short_ = smoothing(short_ema_);
+    k_long_ = smoothing(long_ema_);
+    k_atr_ = smoothing(atr_period_);
+    k_adx_ = smoothing(adx_period_);
+
+    equity_ = initial_capital_;
+    daily_peak_ = equity_;
+    realized_.assign(lanes, 0.0);
+    entry_price_.assign(lanes, 0.0);
+    stop_level_.assign(lanes, 0.0);
+    tp_level_.assign(lanes, 0.0);
+    original_stop_distance_.assign(lanes, 0.0);
+    position_.assign(lanes, 0);
+    trades_.assign(lanes, 0);
+    sessions_driven_ = false;
+    realized_pnl_ = total_pnl_ = 0.0;
+    trade_count_ = 0;
+    for (auto* scratch : {&ema_short_, &ema_long_, &gain_, &loss_, &rsi_, &atr_, &tr_ema_, &plus_ema_, &minus_ema_, &dx_, &adx_, &net_pnl_}) {
+        scratch->assign(lanes, 0.0);
+    }
+    for (auto* mask : {&heavy_loss_, &stop_hit_, &target_hit_}) mask->assign(lanes, 0);
+
+    int longest = 2;
+    for (size_t l = 0; l < lanes; ++l) {
+        longest = std::max({longest, short_ema_[l], long_ema_[l], rsi_period_[l] + 1});
+    }
+    close_window_ = static_cast<size_t>(longest);
+    const int adx_max = *std::max_element(adx_period_.begin(), adx_period_.end());
+    const int atr_max = *std::max_element(atr_period_.begin(), atr_period_.end());
+    tr_hist_.set_capacity(std::max(atr_max, adx_max));
+    plus_dm_hist_.set_capacity(adx_max);
+    minus_dm_hist_.set_capacity(adx_max);
+    dx_capacity_ = static_cast<size_t>(std::max(adx_max, 1));
+    dx_rows_.clear();
+    dx_rows_.reserve(2 * dx_capacity_ * lanes);
+}
+
+int SimpleSMABroadBatchStrategy::begin_bar() {
+    int idx = static_cast<int>(history_length()) - 1;
+    if (idx == 0) {
+        // Placeholders, as in the scalar strategy
+        tr_hist_.push_back(0);
+        plus_dm_hist_.push_back(0);
+        minus_dm_hist_.push_back(0);
+        push_dx_row(std::vector<double>(lane_count(), 0.0));
+    }
+    return idx;
+}
+
+void SimpleSMABroadBatchStrategy::push_dx_row(const std::vector<double>& dx) {
+    const size_t lanes = lane_count();
+    if (dx_rows_.size() == 2 * dx_capacity_ * lanes) {
+        dx_rows_.erase(dx_rows_.begin(), dx_rows_.end() - (dx_capacity_ - 1) * lanes);
+    }
+    dx_rows_.insert(dx_rows_.end(), dx.begin(), dx.end());
+}
+
+void SimpleSMABroadBatchStrategy::dx_ema(std::vector<double>& out) const {
+    // Same as lane_ema, but every lane reads its own column
+    const size_t lanes = lane_count();
+    const int64_t n = static_cast<int64_t>(std::min(dx_rows_.size() / lanes, dx_capacity_));
+    const double* rows = dx_rows_.data() + dx_rows_.size() - n * lanes;
+    std::fill(out.begin(), out.end(), NAN);
+    for (int64_t s = 0; s < n; ++s) {
+        const double* row = rows + s * lanes;
+        for (size_t l = 0; l < lanes; ++l) {
+            const int64_t start = n - adx_period_[l];
+            const double next = row[l] * k_adx_[l] + out[l] * (1 - k_adx_[l]);
+            out[l] = (s == start) ? row[l] : (s > start ? next : out[l]);
+        }
+    }
+}
+
+void SimpleSMABroadBatchStrategy::on_warmup_data(const MarketEvent&) {
+    begin_bar();
+}
+
+void SimpleSMABroadBatchStrategy::on_timer(const TimerEvent& event) {
+    if (event.timer_id() != kSessionStartTimer) return;
+    daily_peak_ = equity_;
+    sessions_driven_ = true;
+}
+
+void SimpleSMABroadBatchStrategy::on_market_data(const MarketEvent& event) {
+    const MarketDataTick& tick = event.tick();
+    if (begin_bar() == 0) return;
+    const size_t lanes = lane_count();
+    auto close = history(Field::Close, close_window_);
+    auto high = history(Field::High, 2);
+    auto low = history(Field::Low, 2);
+    const size_t n = close.size();
+
+    // Indicators, all lanes per pass
+    lane_ema(close, short_ema_, k_short_, ema_short_);
+    lane_ema(close, long_ema_, k_long_, ema_long_);
+    const int rsi_max = *std::max_element(rsi_period_.begin(), rsi_period_.end());
+    std::fill(gain_.begin(), gain_.end(), 0.0);
+    std::fill(loss_.begin(), loss_.end(), 0.0);
+    for (size_t s = n > static_cast<size_t>(rsi_max) ? n - rsi_max : 1; s < n; ++s) {
+        const double delta = close[s] - close[s - 1];
+        for (size_t l = 0; l < lanes; ++l) {
+            const bool active = static_cast<int64_t>(s) >= static_cast<int64_t>(n) - rsi_period_[l];
+            gain_[l] += (active && delta > 0) ? delta : 0.0;
+            loss_[l] -= (active && !(delta > 0)) ? delta : 0.0;
+        }
+    }
+    for (size_t l = 0; l < lanes; ++l) {
+        const double rs = gain_[l] / (loss_[l] == 0 ? 1e-10 : loss_[l]);
+        const double value = (gain_[l] + loss_[l] == 0) ? 50.0 : 100 - (100 / (1 + rs));
+        rsi_[l] = (n < static_cast<size_t>(rsi_period_[l]) + 1) ? NAN : value;
+    }
+    const double vol_ma20 = rolling_mean(volume_history(20), 20);
+
+    const double hl = high[1] - low[1];
+    const double hc = std::abs(high[1] - close[n - 2]);
+    const double lc = std::abs(low[1] - close[n - 2]);
+    tr_hist_.push_back(std::max({hl, hc, lc}));
+    lane_ema(tr_hist_.view(), atr_period_, k_atr_, atr_);
+
+    const double up = high[1] - high[0];
+    const double dn = low[0] - low[1];
+    plus_dm_hist_.push_back((up > dn && up > 0) ? up : 0);
+    minus_dm_hist_.push_back((dn > up && dn > 0) ? dn : 0);
+    lane_ema(tr_hist_.view(), adx_period_, k_adx_, tr_ema_);
+    lane_ema(plus_dm_hist_.view(), adx_period_, k_adx_, plus_ema_);
+    lane_ema(minus_dm_hist_.view(), adx_period_, k_adx_, minus_ema_);
+    for (size_t l = 0; l < lanes; ++l) {
+        const double denom = tr_ema_[l] == 0 ? 1e-10 : tr_ema_[l];
+        const double plus_di = 100 * (plus_ema_[l] / denom);
+        const double minus_di = 100 * (minus_ema_[l] / denom);
+        const double dx = (plus_di + minus_di == 0) ? 0 : (100 * (std::abs(plus_di - minus_di) / (plus_di + minus_di)));
+        dx_[l] = std::isnan(tr_ema_[l]) ? 0 : dx;
+    }
+    push_dx_row(dx_);
+    dx_ema(adx_);
+
+    // Trading. Every condition is a per-lane mask combined without short
+    // circuits and state is written back through selects rather than per-lane
+    // branches; only lanes that hit both levels in one bar fall back to
+    // first_touch()
+    for (size_t l = 0; l < lanes; ++l) {
+        const bool live = position_[l] != 0;
+        const bool heavy_loss = live & (tick.close < entry_price_[l] - 2 * atr_[l]);
+        const double stop = heavy_loss ? entry_price_[l] - 1.5 * original_stop_distance_[l] : stop_level_[l];
+        const double target = tp_level_[l];
+        stop_level_[l] = stop;
+        heavy_loss_[l] = heavy_loss;
+        stop_hit_[l] = live & (tick.low <= stop);
+        target_hit_[l] = live & (tick.high >= target);
+    }
+    for (size_t l = 0; l < lanes; ++l) {
+        if (stop_hit_[l] && target_hit_[l]) stop_hit_[l] = first_touch(stop_level_[l], tp_level_[l]) != Touch::High;
+    }
+
+    // Entries need a flat lane and exits a live one, so both are selected
+    // from the same pre-bar state
+    const double previous_close = close[n - 2];
+    const bool volume_ok = static_cast<double>(volume_history(1).back()) > vol_ma20;
+    size_t exits = 0;
+    for (size_t l = 0; l < lanes; ++l) {
+        const bool live = position_[l] != 0;
+        const bool halted = sessions_driven_ & (equity_[l] < daily_peak_[l] * (1 - max_daily_drawdown_[l]));
+        const bool signal = (ema_short_[l] > ema_long_[l]) & (previous_close <= ema_long_[l]) &
+                            (rsi_lb_[l] < rsi_[l]) & (rsi_[l] < rsi_ub_[l]) & (adx_[l] > adx_threshold_[l]);
+        const double stop = tick.close - atr_[l];
+        const double units = equity_[l] * risk_per_trade_[l] / (tick.close - stop);
+        const bool open = !live & !halted & signal & volume_ok & (units >= 1);
+        const int qty = static_cast<int>(open ? units : 0.0);  // units is NaN while ATR warms up
+        const double entry = tick.close * (1 + slippage_[l]);
+        const double entry_stop = entry - (entry - stop);
+
+        const bool take = !heavy_loss_[l] & (tick.close > entry_price_[l]);
+        const bool exit = live & (stop_hit_[l] | target_hit_[l] | take);
+        const double exit_price = stop_hit_[l] ? stop_level_[l] : (target_hit_[l] ? tp_level_[l] : tick.close * (1 - slippage_[l]));
+        const double profit = (exit_price - entry_price_[l]) * position_[l];
+        const double commission = 20 * 2 + (profit > 0 ? 0.01 * profit : 0);
+        const double net_pnl = exit ? profit - commission : 0.0;
+
+        equity_[l] += net_pnl;
+        realized_[l] += net_pnl;
+        net_pnl_[l] = net_pnl;
+        trades_[l] += exit;
+        exits += exit;
+        daily_peak_[l] = exit ? std::max(daily_peak_[l], equity_[l]) : daily_peak_[l];
+        position_[l] = open ? qty : (exit ? 0 : position_[l]);
+        entry_price_[l] = open ? entry : (exit ? 0.0 : entry_price_[l]);
+        tp_level_[l] = open ? entry + 1.5 * atr_[l] : (exit ? 0.0 : tp_level_[l]);
+        stop_level_[l] = open ? entry_stop : (exit ? 0.0 : stop_level_[l]);
+        original_stop_distance_[l] = open ? entry - entry_stop : (exit ? 0.0 : original_stop_distance_[l]);
+    }
+    // Lane order, as the scalar runs would have summed it
+    for (size_t l = 0; l < lanes; ++l) realized_pnl_ += net_pnl_[l];
+    trade_count_ += exits;
+    total_pnl_ = realized_pnl_;
+}
+
+} // namespace backtest
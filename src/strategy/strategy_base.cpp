@@ -1,11 +1,92 @@
 #include "strategy/strategy_base.h"
+#include "strategy/channel_breakout.h"
 #include "strategy/simple_sma_broad.h"
+#include "core/timer_queue.h"
+#include "utils/config.h"
+#include "utils/time_utils.h"
+#include <stdexcept>
 #include <unordered_map>
 #include <algorithm>
 #include <iostream>
 
 namespace backtest {
 
+void StrategyBase::save_base_state(BinaryWriter& out) const {
+    out.pod(total_pnl_);
+    out.pod(realized_pnl_);
+    out.pod(unrealized_pnl_);
+    out.pod(static_cast<uint64_t>(trade_count_));
+    std::vector<const Position*> held;
+    for (const auto& [instrument, position] : positions_) held.push_back(&position);
+    std::sort(held.begin(), held.end(), [](const Position* a, const Position* b) { return a->instrument < b->instrument; });
+    out.pod(static_cast<uint64_t>(held.size()));
+    for (const Position* position : held) {
+        out.str(position->instrument);
+        out.str(position->strategy);
+        out.pod(position->quantity);
+        out.pod(position->average_price);
+        out.pod(position->unrealized_pnl);
+        out.pod(position->realized_pnl);
+    }
+}
+
+void StrategyBase::load_base_state(BinaryReader& in) {
+    total_pnl_ = in.pod<Price>();
+    realized_pnl_ = in.pod<Price>();
+    unrealized_pnl_ = in.pod<Price>();
+    trade_count_ = in.pod<uint64_t>();
+    positions_.clear();
+    for (auto count = in.pod<uint64_t>(); count > 0; --count) {
+        Position position;
+        position.instrument = in.str();
+        position.strategy = in.str();
+        position.quantity = in.pod<Volume>();
+        position.average_price = in.pod<Price>();
+        position.unrealized_pnl = in.pod<Price>();
+        position.realized_pnl = in.pod<Price>();
+        positions_[position.instrument] = position;
+    }
+}
+
+StrategyBase::Touch StrategyBase::first_touch(Price low_level, Price high_level) const {
+    const auto* ticks = current_slot_ < slot_ticks_.size() ? slot_ticks_[current_slot_] : nullptr;
+    const auto* source = current_slot_ < slot_intrabar_.size() ? slot_intrabar_[current_slot_].get() : nullptr;
+    const size_t row = history_length();
+    if (!ticks || !source || row == 0) return Touch::Unknown;
+
+    // The bar spans up to the next bar's open; the last bar reuses the previous spacing
+    const int64_t open_ns = TimeUtils::to_epoch_ns(ticks->timestamps[row - 1]);
+    int64_t close_ns = open_ns + TimeUtils::kNanosPerMinute;
+    if (row < ticks->size()) close_ns = TimeUtils::to_epoch_ns(ticks->timestamps[row]);
+    else if (row > 1) close_ns = 2 * open_ns - TimeUtils::to_epoch_ns(ticks->timestamps[row - 2]);
+
+    for (const auto& fine : source->rows_between(open_ns, close_ns)) {
+        const bool low = fine.low <= low_level;
+        const bool high = fine.high >= high_level;
+        if (low && high) return Touch::Unknown;
+        if (low) return Touch::Low;
+        if (high) return Touch::High;
+    }
+    return Touch::Unknown;
+}
+
+TimerHandle StrategyBase::add_timer(size_t slot, Duration period, Timestamp first) {
+    if (!timer_queue_) throw std::logic_error("Strategy " + strategy_id_ + " is not attached to an engine");
+    const size_t lane = slot < slot_timer_lanes_.size() ? slot_timer_lanes_[slot] : TimerQueue::kNoLane;
+    return timer_queue_->add(this, slot, lane, TimeUtils::to_epoch_ns(first), period.count());
+}
+
+TimerHandle StrategyBase::add_timers(Duration period, Timestamp first) {
+    if (slot_count() == 0) throw std::logic_error("Strategy " + strategy_id_ + " has no instruments to time");
+    const TimerHandle handle = add_timer(0, period, first);
+    for (size_t slot = 1; slot < slot_count(); ++slot) add_timer(slot, period, first);
+    return handle;
+}
+
+void StrategyBase::cancel_timer(TimerHandle handle) {
+    if (timer_queue_) timer_queue_->cancel(handle);
+}
+
 namespace StrategyFactory {
 std::unique_ptr<StrategyBase> create_sma_strategy(const StrategyId& id, int short_period, int long_period, SMAStrategy::PriceMode price_mode, std::unordered_map<std::string, std::string> price_columns) {
     return std::make_unique<SMAStrategy>(id, short_period, long_period, price_mode, std::move(price_columns));
@@ -22,4 +103,59 @@ std::unique_ptr<StrategyBase> StrategyFactory::create_momentum_strategy(const St
     return std::make_unique<MomentumStrategy>(id, lookback, threshold);
 }
 
+namespace {
+
+std::unique_ptr<StrategyBase> create_configured_type(const Config& run_config) {
+    const auto& config = run_config.strategy;
+    auto p = [&config](const char* name, double fallback) { return config.param(name, fallback); };
+    if (config.type == "simple_sma_broad") {
+        auto strategy = std::make_unique<SimpleSMABroadStrategy>(config.id,
+            static_cast<int>(p("short_ema", 9)), static_cast<int>(p("long_ema", 21)),
+            static_cast<int>(p("rsi_period", 14)), p("rsi_lb", 40.0), p("rsi_ub", 70.0),
+            static_cast<int>(p("atr_period", 14)), static_cast<int>(p("adx_period", 14)),
+            p("adx_threshold", 20.0), p("risk_per_trade", 0.01), run_config.initial_capital,
+            p("slippage", 0.0005), p("max_daily_drawdown", 0.03));
+        strategy->set_log_path(run_config.log_path);
+        return strategy;
+    }
+    if (config.type == "sma") {
+        return StrategyFactory::create_sma_strategy(config.id, static_cast<int>(p("short_period", 12)),
+                                                    static_cast<int>(p("long_period", 26)));
+    }
+    if (config.type == "mean_reversion") {
+        return StrategyFactory::create_mean_reversion_strategy(config.id, static_cast<int>(p("lookback", 20)),
+                                                               p("threshold", 2.0));
+    }
+    if (config.type == "momentum") {
+        return StrategyFactory::create_momentum_strategy(config.id, static_cast<int>(p("lookback", 10)),
+                                                         p("threshold", 0.02));
+    }
+    if (config.type == "channel_breakout") {
+        return std::make_unique<ChannelBreakoutStrategy>(config.id, static_cast<size_t>(p("lookback", 20)),
+                                                         std::chrono::minutes(static_cast<int64_t>(p("cooldown_minutes", 30))),
+                                                         static_cast<Volume>(p("quantity", 1)));
+    }
+    throw std::invalid_argument("Unknown strategy type: " + config.type);
+}
+
+} // namespace
+
+std::unique_ptr<StrategyBase> StrategyFactory::create_from_config(const Config& run_config) {
+    const auto& config = run_config.strategy;
+    auto strategy = create_configured_type(run_config);
+    for (const auto& instrument : config.instruments) strategy->subscribe(instrument);
+    
+    // Explicit session settings replace the strategy's built-in session
+    const double warmup = config.param("warmup_ticks", 0.0);
+    if (!config.session.empty() || !config.holidays.empty() || warmup > 0) {
+        SessionSpec session = config.session.empty() ? strategy->session() : SessionSpec::parse(config.session);
+        if (!config.holidays.empty()) session.holidays = config.holidays;
+        session.warmup_ticks = static_cast<size_t>(warmup);
+        strategy->set_session(session);
+    }
+    const double conflation = config.param("conflation_seconds", 0.0);
+    if (conflation > 0) strategy->set_conflation(std::chrono::duration_cast<Duration>(std::chrono::duration<double>(conflation)));
+    return strategy;
+}
+
 } // namespace backtest
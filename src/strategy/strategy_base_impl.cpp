@@ -1,4 +1,6 @@
 #include "strategy/strategy_base.h"
+#include "core/event_bus.h"
+#include "utils/trace.h"
 #include <iostream>
 #include <numeric>
 #include <algorithm>
@@ -28,7 +30,8 @@ static Price get_price_from_columns(const MarketDataTick& tick, SMAStrategy::Pri
 
 void SMAStrategy::on_market_data(const MarketEvent& event) {
     const auto& tick = event.tick();
-    auto& hist = price_histories_[tick.instrument];
+    if (current_slot() >= price_histories_.size()) price_histories_.resize(current_slot() + 1);
+    auto& hist = price_histories_[current_slot()];
     Price price = get_price_from_columns(tick, price_mode_, price_columns_);
     hist.prices.push_back(price);
     if (hist.prices.size() > static_cast<size_t>(long_period_)) hist.prices.erase(hist.prices.begin());
@@ -43,20 +46,32 @@ void SMAStrategy::on_market_data(const MarketEvent& event) {
         hist.has_signal = false;
     }
 }
-void SMAStrategy::initialize() {}
+void SMAStrategy::initialize() {
+    price_histories_.assign(slot_count(), PriceHistory{});
+}
 void SMAStrategy::on_fill(const FillEvent& event) {}
 
 // --- MeanReversionStrategy ---
-void MeanReversionStrategy::initialize() {}
+void MeanReversionStrategy::initialize() {
+    statistical_data_.assign(slot_count(), StatisticalData{});
+}
 void MeanReversionStrategy::on_market_data(const MarketEvent& event) {}
 void MeanReversionStrategy::on_fill(const FillEvent& event) {}
 
 // --- MomentumStrategy ---
-void MomentumStrategy::initialize() {}
+void MomentumStrategy::initialize() {
+    momentum_data_.assign(slot_count(), MomentumData{});
+}
 void MomentumStrategy::on_market_data(const MarketEvent& event) {}
 void MomentumStrategy::on_fill(const FillEvent& event) {}
 
-void StrategyBase::execute_order(const InstrumentId& instrument, Side side, Price price, Volume qty) const {
+void StrategyBase::emit_signal(const InstrumentId& instrument, SignalEvent::SignalType signal_type, Price strength) const {
+    SignalEvent event(instrument, strategy_id_, signal_type, strength);
+    GlobalEventBus::instance().publish_sync(event);
+}
+
+OrderId StrategyBase::execute_order(const InstrumentId& instrument, Side side, Price price, Volume qty) const {
+    TraceSpan span("execute_order");
     static OrderId next_id = 1;
     Order order(next_id++, instrument, strategy_id_, side, OrderType::MARKET, price, qty);
     order.status = OrderStatus::FILLED;
@@ -70,6 +85,7 @@ void StrategyBase::execute_order(const InstrumentId& instrument, Side side, Pric
         pos.average_price = price;
     }
     const_cast<size_t&>(trade_count_)++;
+    return order.id;
 }
 
 } // namespace backtest
@@ -1,7 +1,572 @@
 #include "utils/config.h"
+#include "utils/binary_io.h"
+#include "utils/time_utils.h"
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 namespace backtest {
 
-// Implementation for Config methods can go here if needed in the future
+namespace {
 
+// Fixed numeric keys. Strategy parameters ("strategy.*") are open-ended and
+// handled separately.
+struct NumberField {
+    const char* key;
+    double (*get)(const Config&);
+    void (*set)(Config&, double);
+};
+
+const std::vector<NumberField>& number_fields() {
+    static const std::vector<NumberField> fields = {
+        {"run.initial_capital",
+         [](const Config& c) { return c.initial_capital; },
+         [](Config& c, double v) { c.initial_capital = v; }},
+        {"cost.slippage_base_rate",
+         [](const Config& c) { return c.cost.slippage_base_rate; },
+         [](Config& c, double v) { c.cost.slippage_base_rate = v; }},
+        {"cost.slippage_impact",
+         [](const Config& c) { return c.cost.slippage_impact; },
+         [](Config& c, double v) { c.cost.slippage_impact = v; }},
+        {"cost.maker_fee_rate",
+         [](const Config& c) { return c.cost.maker_fee_rate; },
+         [](Config& c, double v) { c.cost.maker_fee_rate = v; }},
+        {"cost.taker_fee_rate",
+         [](const Config& c) { return c.cost.taker_fee_rate; },
+         [](Config& c, double v) { c.cost.taker_fee_rate = v; }},
+        {"cost.fixed_fee",
+         [](const Config& c) { return c.cost.fixed_fee; },
+         [](Config& c, double v) { c.cost.fixed_fee = v; }},
+        {"cost.min_commission",
+         [](const Config& c) { return c.cost.min_commission; },
+         [](Config& c, double v) { c.cost.min_commission = v; }},
+        {"cost.max_commission",
+         [](const Config& c) { return c.cost.max_commission; },
+         [](Config& c, double v) { c.cost.max_commission = v; }},
+        {"risk.max_position_size",
+         [](const Config& c) { return static_cast<double>(c.risk.max_position_size); },
+         [](Config& c, double v) { c.risk.max_position_size = static_cast<Volume>(v); }},
+        {"risk.max_notional_exposure",
+         [](const Config& c) { return c.risk.max_notional_exposure; },
+         [](Config& c, double v) { c.risk.max_notional_exposure = v; }},
+        {"risk.max_portfolio_exposure",
+         [](const Config& c) { return c.risk.max_portfolio_exposure; },
+         [](Config& c, double v) { c.risk.max_portfolio_exposure = v; }},
+        {"risk.max_daily_loss",
+         [](const Config& c) { return c.risk.max_daily_loss; },
+         [](Config& c, double v) { c.risk.max_daily_loss = v; }},
+        {"risk.max_total_loss",
+         [](const Config& c) { return c.risk.max_total_loss; },
+         [](Config& c, double v) { c.risk.max_total_loss = v; }},
+        {"risk.max_drawdown",
+         [](const Config& c) { return c.risk.max_drawdown; },
+         [](Config& c, double v) { c.risk.max_drawdown = v; }},
+        {"risk.max_orders_per_minute",
+         [](const Config& c) { return static_cast<double>(c.risk.max_orders_per_minute); },
+         [](Config& c, double v) { c.risk.max_orders_per_minute = static_cast<uint32_t>(v); }},
+        {"risk.max_orders_per_day",
+         [](const Config& c) { return static_cast<double>(c.risk.max_orders_per_day); },
+         [](Config& c, double v) { c.risk.max_orders_per_day = static_cast<uint32_t>(v); }},
+        {"risk.max_order_size",
+         [](const Config& c) { return static_cast<double>(c.risk.max_order_size); },
+         [](Config& c, double v) { c.risk.max_order_size = static_cast<Volume>(v); }},
+        {"risk.loss_cooldown_minutes",
+         [](const Config& c) { return static_cast<double>(c.risk.loss_cooldown.count()); },
+         [](Config& c, double v) { c.risk.loss_cooldown = std::chrono::minutes(static_cast<int64_t>(v)); }},
+        {"risk.drawdown_cooldown_minutes",
+         [](const Config& c) { return static_cast<double>(c.risk.drawdown_cooldown.count()); },
+         [](Config& c, double v) { c.risk.drawdown_cooldown = std::chrono::minutes(static_cast<int64_t>(v)); }},
+        {"risk.enable_position_limits",
+         [](const Config& c) { return c.risk.enable_position_limits ? 1.0 : 0.0; },
+         [](Config& c, double v) { c.risk.enable_position_limits = v != 0.0; }},
+        {"risk.enable_loss_limits",
+         [](const Config& c) { return c.risk.enable_loss_limits ? 1.0 : 0.0; },
+         [](Config& c, double v) { c.risk.enable_loss_limits = v != 0.0; }},
+        {"risk.enable_exposure_limits",
+         [](const Config& c) { return c.risk.enable_exposure_limits ? 1.0 : 0.0; },
+         [](Config& c, double v) { c.risk.enable_exposure_limits = v != 0.0; }},
+        {"risk.enable_rate_limiting",
+         [](const Config& c) { return c.risk.enable_rate_limiting ? 1.0 : 0.0; },
+         [](Config& c, double v) { c.risk.enable_rate_limiting = v != 0.0; }},
+        {"latency.market_data_us",
+         [](const Config& c) { return std::chrono::duration<double, std::micro>(c.latency.market_data).count(); },
+         [](Config& c, double v) { c.latency.market_data = Duration(static_cast<int64_t>(v * 1000.0)); }},
+        {"latency.order_us",
+         [](const Config& c) { return std::chrono::duration<double, std::micro>(c.latency.order).count(); },
+         [](Config& c, double v) { c.latency.order = Duration(static_cast<int64_t>(v * 1000.0)); }},
+    };
+    return fields;
+}
+
+const NumberField* find_number_field(const std::string& key) {
+    for (const auto& field : number_fields()) {
+        if (key == field.key) return &field;
+    }
+    return nullptr;
+}
+
+bool is_strategy_param(const std::string& key) {
+    return key.rfind("strategy.", 0) == 0 && key != "strategy.type" && key != "strategy.id" &&
+           key != "strategy.instruments" && key != "strategy.session" && key != "strategy.holidays";
+}
+
+// List-valued keys other than the per-source data lists (const or mutable Config)
+template<typename ConfigT>
+auto string_list(ConfigT& config, const std::string& key) -> decltype(&config.calendar.holidays) {
+    if (key == "strategy.instruments") return &config.strategy.instruments;
+    if (key == "strategy.holidays") return &config.strategy.holidays;
+    if (key == "calendar.holidays") return &config.calendar.holidays;
+    return nullptr;
+}
+
+// Typed entry groups written by RunPlan::save besides the numeric keys
+const char* const kStringKeys[] = {"strategy.type", "strategy.id", "cost.slippage_model",
+                                   "run.log_path", "data.shared_cache", "strategy.session",
+                                   "calendar.exchange", "run.cache_dir", "data.huge_pages", "data.numa",
+                                   "data.archive", "data.from", "data.to"};
+const char* const kDataListKeys[] = {"data.files", "data.instruments", "data.intrabar_files"};
+
+// Per-source field behind a data list key (const or mutable source)
+template<typename SourceT>
+auto source_field(SourceT& source, const std::string& key) -> decltype(&source.path) {
+    if (key == "data.files") return &source.path;
+    if (key == "data.intrabar_files") return &source.intrabar_path;
+    return &source.instrument;
+}
+const char* const kListKeys[] = {"strategy.instruments", "strategy.holidays", "calendar.holidays"};
+
+// Where results are written or data lives, not what they are
+bool is_location_key(const std::string& key) {
+    return key == "run.log_path" || key == "data.shared_cache" || key == "run.cache_dir" || key == "data.files" ||
+           key == "data.huge_pages" || key == "data.numa" || key == "data.archive";
+}
+
+std::string trim(const std::string& s) {
+    auto begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    auto end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+std::string unquote(const std::string& s) {
+    if (s.size() >= 2 && (s.front() == '"' || s.front() == '\'') && s.back() == s.front()) {
+        return s.substr(1, s.size() - 2);
+    }
+    return s;
+}
+
+// Split "[a, b, c]" (or a bare comma list) into trimmed, unquoted items
+std::vector<std::string> split_list(const std::string& raw) {
+    std::string body = trim(raw);
+    if (!body.empty() && body.front() == '[') body = body.substr(1);
+    if (!body.empty() && body.back() == ']') body.pop_back();
+    std::vector<std::string> items;
+    std::string item;
+    bool in_quotes = false;
+    for (char ch : body) {
+        if (ch == '"') in_quotes = !in_quotes;
+        if (ch == ',' && !in_quotes) {
+            if (!trim(item).empty()) items.push_back(unquote(trim(item)));
+            item.clear();
+        } else {
+            item += ch;
+        }
+    }
+    if (!trim(item).empty()) items.push_back(unquote(trim(item)));
+    return items;
+}
+
+double parse_number(const std::string& key, const std::string& raw) {
+    std::string value = unquote(trim(raw));
+    if (value == "true") return 1.0;
+    if (value == "false") return 0.0;
+    try {
+        size_t used = 0;
+        double result = std::stod(value, &used);
+        if (used != value.size()) throw std::invalid_argument(value);
+        return result;
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Config key '" + key + "' expects a number, got: " + raw);
+    }
+}
+
+std::string stem_of(const std::string& path) {
+    auto slash = path.find_last_of("/\\");
+    std::string base = (slash == std::string::npos) ? path : path.substr(slash + 1);
+    auto dot = base.rfind('.');
+    return (dot == std::string::npos) ? base : base.substr(0, dot);
+}
+
+std::string strip_comment(const std::string& line) {
+    bool in_quotes = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == '"') in_quotes = !in_quotes;
+        if (line[i] == '#' && !in_quotes) return line.substr(0, i);
+    }
+    return line;
+}
+
+// --- Binary run plan encoding ---
+constexpr char kPlanMagic[8] = {'N', 'E', 'M', 'O', 'P', 'L', 'A', 'N'};
+constexpr uint32_t kPlanVersion = 1;
+
+enum class EntryKind : uint8_t { NUMBER = 0, STRING = 1, LIST = 2 };
+
+} // namespace
+
+size_t SweepRange::count() const {
+    if (step <= 0.0 || stop < start) return 1;
+    // Small epsilon so 0.1-style steps still include the end point
+    return static_cast<size_t>(std::floor((stop - start) / step + 1e-9)) + 1;
+}
+
+Config Config::load_file(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) throw std::runtime_error("Could not open config file: " + path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return parse(buffer.str());
+}
+
+Config Config::parse(const std::string& text) {
+    Config config;
+    std::istringstream input(text);
+    std::string line;
+    std::string section;
+    size_t line_no = 0;
+    while (std::getline(input, line)) {
+        ++line_no;
+        line = trim(strip_comment(line));
+        if (line.empty()) continue;
+        if (line.front() == '[') {
+            if (line.back() != ']') {
+                throw std::invalid_argument("Malformed section header on line " + std::to_string(line_no));
+            }
+            section = trim(line.substr(1, line.size() - 2));
+            continue;
+        }
+        auto eq = line.find('=');
+        if (eq == std::string::npos) {
+            throw std::invalid_argument("Expected key = value on line " + std::to_string(line_no));
+        }
+        std::string name = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        if (section == "sweep") {
+            auto bounds = split_list(value);
+            if (bounds.size() != 3) {
+                throw std::invalid_argument("Sweep '" + name + "' expects [start, stop, step]");
+            }
+            if (!find_number_field(name) && !is_strategy_param(name)) {
+                throw std::invalid_argument("Sweep key is not numeric: " + name);
+            }
+            config.sweeps.push_back(SweepRange{name, parse_number(name, bounds[0]),
+                                               parse_number(name, bounds[1]),
+                                               parse_number(name, bounds[2])});
+            continue;
+        }
+        config.set_value(section.empty() ? name : section + "." + name, value);
+    }
+    return config;
 }
+
+void Config::set_value(const std::string& key, const std::string& value) {
+    if (key == "data.files") {
+        // Several files without explicit instruments are named after the file stem
+        const InstrumentId default_instrument = DataSourceConfig{}.instrument;
+        auto files = split_list(value);
+        data.resize(files.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            data[i].path = files[i];
+            if (files.size() > 1 && data[i].instrument == default_instrument) {
+                data[i].instrument = stem_of(files[i]);
+            }
+        }
+    } else if (key == "data.intrabar_files") {
+        auto files = split_list(value);
+        if (data.size() < files.size()) data.resize(files.size());
+        for (size_t i = 0; i < files.size(); ++i) data[i].intrabar_path = files[i];
+    } else if (key == "data.instruments") {
+        auto instruments = split_list(value);
+        if (data.size() < instruments.size()) data.resize(instruments.size());
+        for (size_t i = 0; i < instruments.size(); ++i) data[i].instrument = instruments[i];
+    } else if (key == "data.shared_cache") {
+        shared_cache = unquote(trim(value));
+    } else if (key == "data.huge_pages") {
+        huge_pages = unquote(trim(value));
+    } else if (key == "data.numa") {
+        numa = unquote(trim(value));
+    } else if (key == "data.archive") {
+        archive = unquote(trim(value));
+    } else if (key == "data.from" || key == "data.to") {
+        std::string text = unquote(trim(value));
+        int64_t epoch_ns = 0;
+        if (!text.empty() && !TimeUtils::parse_timestamp(text, epoch_ns)) {
+            throw std::invalid_argument("Invalid date for " + key + ": " + text);
+        }
+        (key == "data.from" ? from : to) = text;
+    } else if (key == "strategy.type") {
+        strategy.type = unquote(trim(value));
+    } else if (auto* list = string_list(*this, key)) {
+        *list = split_list(value);
+    } else if (key == "calendar.exchange") {
+        calendar.exchange = unquote(trim(value));
+    } else if (key == "strategy.session") {
+        strategy.session = unquote(trim(value));
+    } else if (key == "strategy.id") {
+        strategy.id = unquote(trim(value));
+    } else if (key == "cost.slippage_model") {
+        cost.slippage_model = unquote(trim(value));
+    } else if (key == "run.log_path") {
+        log_path = unquote(trim(value));
+    } else if (key == "run.cache_dir") {
+        cache_dir = unquote(trim(value));
+    } else {
+        set_number(key, parse_number(key, value));
+    }
+}
+
+void Config::set_number(const std::string& key, double value) {
+    number_setter(key)(*this, value);
+}
+
+Config::NumberSetter Config::number_setter(const std::string& key) {
+    if (const auto* field = find_number_field(key)) {
+        return field->set;
+    }
+    if (is_strategy_param(key)) {
+        std::string name = key.substr(std::strlen("strategy."));
+        return [name](Config& config, double value) { config.strategy.params[name] = value; };
+    }
+    throw std::invalid_argument("Unknown config key: " + key);
+}
+
+std::string Config::get_value(const std::string& key) const {
+    if (key == "strategy.type") return strategy.type;
+    if (key == "strategy.id") return strategy.id;
+    if (key == "cost.slippage_model") return cost.slippage_model;
+    if (key == "run.log_path") return log_path;
+    if (key == "run.cache_dir") return cache_dir;
+    if (key == "data.shared_cache") return shared_cache;
+    if (key == "data.huge_pages") return huge_pages;
+    if (key == "data.numa") return numa;
+    if (key == "data.archive") return archive;
+    if (key == "data.from") return from;
+    if (key == "data.to") return to;
+    if (key == "strategy.session") return strategy.session;
+    if (key == "calendar.exchange") return calendar.exchange;
+    if (const auto* items = string_list(*this, key)) {
+        std::string joined;
+        for (const auto& instrument : *items) {
+            if (!joined.empty()) joined += ",";
+            joined += instrument;
+        }
+        return joined;
+    }
+    if (key == "data.files" || key == "data.instruments" || key == "data.intrabar_files") {
+        std::string joined;
+        for (const auto& source : data) {
+            if (!joined.empty()) joined += ",";
+            joined += *source_field(source, key);
+        }
+        return joined;
+    }
+    if (const auto* field = find_number_field(key)) {
+        std::ostringstream oss;
+        oss << field->get(*this);
+        return oss.str();
+    }
+    if (is_strategy_param(key)) {
+        auto it = strategy.params.find(key.substr(std::strlen("strategy.")));
+        if (it != strategy.params.end()) {
+            std::ostringstream oss;
+            oss << it->second;
+            return oss.str();
+        }
+        return "";
+    }
+    throw std::invalid_argument("Unknown config key: " + key);
+}
+
+std::pair<int64_t, int64_t> Config::data_range() const {
+    int64_t first = std::numeric_limits<int64_t>::min();
+    int64_t last = std::numeric_limits<int64_t>::max();
+    if (!from.empty()) TimeUtils::parse_timestamp(from, first);
+    if (!to.empty()) {
+        TimeUtils::parse_timestamp(to, last);
+        if (to.size() == 10) last += TimeUtils::kNanosPerDay - 1;
+    }
+    return {first, last};
+}
+
+std::string Config::canonical_text() const {
+    std::ostringstream out;
+    out << std::hexfloat;  // Exact doubles
+    for (const auto& field : number_fields()) out << field.key << '=' << field.get(*this) << '\n';
+    for (const auto& [name, value] : strategy.params) out << "strategy." << name << '=' << value << '\n';
+    for (const char* key : kStringKeys) {
+        if (!is_location_key(key)) out << key << '=' << get_value(key) << '\n';
+    }
+    for (const char* key : kDataListKeys) {
+        if (!is_location_key(key)) out << key << '=' << get_value(key) << '\n';
+    }
+    for (const char* key : kListKeys) out << key << '=' << get_value(key) << '\n';
+    return out.str();
+}
+
+// --- RunPlan ---
+
+RunPlan RunPlan::compile(const Config& base) {
+    RunPlan plan;
+    plan.base_ = base;
+    plan.base_.sweeps.clear();
+    plan.run_count_ = 1;
+    for (const auto& sweep : base.sweeps) {
+        plan.keys_.push_back(sweep.key);
+        plan.run_count_ *= sweep.count();
+    }
+
+    // Cartesian product, first sweep varies slowest
+    const size_t params = plan.keys_.size();
+    plan.values_.resize(plan.run_count_ * params);
+    for (size_t run = 0; run < plan.run_count_; ++run) {
+        size_t remainder = run;
+        for (size_t p = params; p-- > 0;) {
+            const auto& sweep = base.sweeps[p];
+            plan.values_[run * params + p] = sweep.value(remainder % sweep.count());
+            remainder /= sweep.count();
+        }
+    }
+    plan.resolve_setters();
+    return plan;
+}
+
+void RunPlan::save(const std::string& path) const {
+    BinaryWriter out;
+    out.raw(kPlanMagic, sizeof(kPlanMagic));
+    out.pod(kPlanVersion);
+
+    // Base config as typed entries
+    const auto& fields = number_fields();
+    const uint32_t entry_count = static_cast<uint32_t>(fields.size() + base_.strategy.params.size() +
+                                                       std::size(kStringKeys) + std::size(kDataListKeys) +
+                                                       std::size(kListKeys));
+    out.pod(entry_count);
+    for (const auto& field : fields) {
+        out.pod(EntryKind::NUMBER);
+        out.str(field.key);
+        out.pod(field.get(base_));
+    }
+    for (const auto& [name, value] : base_.strategy.params) {
+        out.pod(EntryKind::NUMBER);
+        out.str("strategy." + name);
+        out.pod(value);
+    }
+    for (const char* key : kStringKeys) {
+        out.pod(EntryKind::STRING);
+        out.str(key);
+        out.str(base_.get_value(key));
+    }
+    for (const char* key : kDataListKeys) {
+        out.pod(EntryKind::LIST);
+        out.str(key);
+        out.pod(static_cast<uint32_t>(base_.data.size()));
+        for (const auto& source : base_.data) {
+            out.str(*source_field(source, key));
+        }
+    }
+    for (const char* key : kListKeys) {
+        const auto& items = *string_list(base_, key);
+        out.pod(EntryKind::LIST);
+        out.str(key);
+        out.pod(static_cast<uint32_t>(items.size()));
+        for (const auto& item : items) out.str(item);
+    }
+
+    // Swept parameters and the dense value matrix
+    out.pod(static_cast<uint64_t>(run_count_));
+    out.pod(static_cast<uint32_t>(keys_.size()));
+    for (const auto& key : keys_) out.str(key);
+    out.raw(values_.data(), values_.size() * sizeof(double));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) throw std::runtime_error("Could not write run plan: " + path);
+    file.write(out.buffer().data(), static_cast<std::streamsize>(out.buffer().size()));
+}
+
+RunPlan RunPlan::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Could not open run plan: " + path);
+    std::vector<char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    BinaryReader in(buffer, "Run plan");
+    if (std::memcmp(in.take(sizeof(kPlanMagic)), kPlanMagic, sizeof(kPlanMagic)) != 0) {
+        throw std::runtime_error("Not a run plan file: " + path);
+    }
+    if (in.pod<uint32_t>() != kPlanVersion) {
+        throw std::runtime_error("Unsupported run plan version: " + path);
+    }
+
+    RunPlan plan;
+    const auto entries = in.pod<uint32_t>();
+    for (uint32_t i = 0; i < entries; ++i) {
+        auto kind = in.pod<EntryKind>();
+        auto key = in.str();
+        switch (kind) {
+            case EntryKind::NUMBER:
+                plan.base_.set_number(key, in.pod<double>());
+                break;
+            case EntryKind::STRING:
+                plan.base_.set_value(key, in.str());
+                break;
+            case EntryKind::LIST: {
+                auto count = in.pod<uint32_t>();
+                if (auto* items = string_list(plan.base_, key)) {
+                    for (uint32_t j = 0; j < count; ++j) items->push_back(in.str());
+                    break;
+                }
+                if (plan.base_.data.size() < count) plan.base_.data.resize(count);
+                for (uint32_t j = 0; j < count; ++j) {
+                    auto item = in.str();
+                    *source_field(plan.base_.data[j], key) = item;
+                }
+                break;
+            }
+            default:
+                throw std::runtime_error("Run plan is truncated or corrupt");
+        }
+    }
+
+    plan.run_count_ = static_cast<size_t>(in.pod<uint64_t>());
+    const auto params = in.pod<uint32_t>();
+    for (uint32_t i = 0; i < params; ++i) plan.keys_.push_back(in.str());
+    plan.values_.resize(plan.run_count_ * params);
+    std::memcpy(plan.values_.data(), in.take(plan.values_.size() * sizeof(double)),
+                plan.values_.size() * sizeof(double));
+    plan.resolve_setters();
+    return plan;
+}
+
+Config RunPlan::config_for(size_t run) const {
+    Config config = base_;
+    apply(run, config);
+    return config;
+}
+
+void RunPlan::apply(size_t run, Config& config) const {
+    if (run >= run_count_) throw std::out_of_range("Run index out of range: " + std::to_string(run));
+    const double* values = run_values(run);
+    for (size_t p = 0; p < setters_.size(); ++p) {
+        setters_[p](config, values[p]);
+    }
+}
+
+void RunPlan::resolve_setters() {
+    setters_.clear();
+    for (const auto& key : keys_) setters_.push_back(Config::number_setter(key));
+}
+
+} // namespace backtest
@@ -0,0 +1,254 @@
+#include "utils/memory_placement.h"
+#include "utils/logging.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <cstring>
+    #include <sched.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace backtest {
+
+namespace {
+
+constexpr size_t kHugePageBytes = 2 * 1024 * 1024;
+
+size_t round_up(size_t value, size_t granule) {
+    return (value + granule - 1) / granule * granule;
+}
+
+// "0-3,8,10-11" as used by /sys/devices/system/node
+std::vector<int> parse_list(const std::string& text) {
+    std::vector<int> items;
+    std::stringstream in(text);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.find_first_not_of(" \t\r\n") == std::string::npos) continue;
+        auto dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int i = first; i <= last; ++i) items.push_back(i);
+    }
+    return items;
+}
+
+std::string read_sys(const std::string& path) {
+    std::ifstream file(path);
+    std::string text;
+    std::getline(file, text);
+    return text;
+}
+
+std::shared_ptr<char> heap_block(size_t bytes) {
+    return std::shared_ptr<char>(new char[bytes](), std::default_delete<char[]>());
+}
+
+void warn(const std::string& message) {
+    Logger::get().warn("MemoryPlacement", message);
+}
+
+#ifdef __linux__
+
+// mbind(2) modes; <numaif.h> comes with libnuma, which we do not link
+constexpr int kMpolBind = 2;
+constexpr int kMpolInterleave = 3;
+
+bool bind_pages(void* addr, size_t bytes, const MemoryPlacement& placement) {
+    const size_t nodes = numa_node_count();
+    constexpr size_t kBits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(nodes / kBits + 1, 0);
+    int mode = kMpolInterleave;
+    if (placement.numa == NumaPolicy::Interleave) {
+        for (size_t node = 0; node < nodes; ++node) mask[node / kBits] |= 1ul << (node % kBits);
+    } else {
+        const int node = placement.node >= 0 ? placement.node : current_numa_node();
+        if (static_cast<size_t>(node) >= nodes) return false;
+        mask[node / kBits] |= 1ul << (node % kBits);
+        mode = kMpolBind;
+    }
+    return ::syscall(SYS_mbind, addr, bytes, mode, mask.data(), mask.size() * kBits + 1, 0) == 0;
+}
+
+// Anonymous mapping starting on a 2 MB boundary, so every full 2 MB stretch can become one huge page
+void* map_aligned(size_t bytes) {
+    void* raw = ::mmap(nullptr, bytes + kHugePageBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    auto begin = reinterpret_cast<uintptr_t>(raw);
+    auto aligned = round_up(begin, kHugePageBytes);
+    if (aligned > begin) ::munmap(raw, aligned - begin);
+    const size_t tail = begin + kHugePageBytes - aligned;
+    if (tail > 0) ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    return reinterpret_cast<void*>(aligned);
+}
+
+#endif
+
+} // namespace
+
+MemoryPlacement MemoryPlacement::parse(const std::string& huge_pages, const std::string& numa) {
+    MemoryPlacement placement;
+    if (huge_pages == "transparent") placement.huge_pages = HugePages::Transparent;
+    else if (huge_pages == "reserved") placement.huge_pages = HugePages::Reserved;
+    else if (!huge_pages.empty() && huge_pages != "off") {
+        throw std::invalid_argument("data.huge_pages must be off, transparent or reserved: " + huge_pages);
+    }
+    if (numa == "interleave") placement.numa = NumaPolicy::Interleave;
+    else if (numa == "replicate") placement.numa = NumaPolicy::Replicate;
+    else if (!numa.empty() && numa != "off") {
+        throw std::invalid_argument("data.numa must be off, interleave or replicate: " + numa);
+    }
+    return placement;
+}
+
+#ifdef __linux__
+
+std::shared_ptr<char> allocate_placed(size_t bytes, const MemoryPlacement& placement) {
+    if (placement.is_default() || bytes == 0) return heap_block(bytes);
+
+    const bool huge = placement.huge_pages != HugePages::Off;
+    const size_t size = huge ? round_up(bytes, kHugePageBytes) : round_up(bytes, static_cast<size_t>(::sysconf(_SC_PAGESIZE)));
+    void* addr = nullptr;
+    if (placement.huge_pages == HugePages::Reserved) {
+        addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr == MAP_FAILED) {
+            addr = nullptr;
+            warn("No reserved huge pages for " + std::to_string(size >> 20) + " MB (" +
+                 std::strerror(errno) + "), using transparent huge pages");
+        }
+    }
+    if (!addr) {
+        addr = huge ? map_aligned(size)
+                    : ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (!addr || addr == MAP_FAILED) throw std::runtime_error(std::string("mmap: ") + std::strerror(errno));
+        if (huge && ::madvise(addr, size, MADV_HUGEPAGE) != 0) {
+            warn(std::string("madvise(MADV_HUGEPAGE) failed: ") + std::strerror(errno));
+        }
+    }
+    // Policy must be set before the first touch places the pages
+    if (placement.numa != NumaPolicy::Off && numa_node_count() > 1 && !bind_pages(addr, size, placement)) {
+        warn(std::string("mbind failed, pages stay where first touched: ") + std::strerror(errno));
+    }
+    return std::shared_ptr<char>(static_cast<char*>(addr), [size](char* p) { ::munmap(p, size); });
+}
+
+size_t numa_node_count() {
+    static const size_t count = [] {
+        auto nodes = parse_list(read_sys("/sys/devices/system/node/online"));
+        return nodes.empty() ? size_t{1} : static_cast<size_t>(nodes.back()) + 1;
+    }();
+    return count;
+}
+
+int current_numa_node() {
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return 0;
+    return static_cast<int>(node);
+}
+
+std::vector<int> numa_node_cpus(int node) {
+    return parse_list(read_sys("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+}
+
+bool pin_to_numa_node(int node) {
+    auto cpus = numa_node_cpus(node);
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+size_t huge_page_bytes(const void* addr) {
+    const auto target = reinterpret_cast<uintptr_t>(addr);
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool inside = false;
+    while (std::getline(smaps, line)) {
+        uintptr_t begin = 0;
+        uintptr_t end = 0;
+        char dash = 0;
+        std::istringstream header(line);
+        if (header >> std::hex >> begin >> dash >> end && dash == '-') {
+            inside = target >= begin && target < end;
+        } else if (inside && (line.rfind("AnonHugePages:", 0) == 0 || line.rfind("Private_Hugetlb:", 0) == 0)) {
+            size_t kb = std::stoul(line.substr(line.find(':') + 1));
+            if (kb > 0) return kb * 1024;
+        }
+    }
+    return 0;
+}
+
+double local_page_fraction(const void* addr, size_t bytes) {
+    if (numa_node_count() < 2 || bytes == 0) return 1.0;
+    const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<uintptr_t>(addr) / page * page;
+    // Sample up to 4096 pages across the range
+    const size_t pages = (reinterpret_cast<uintptr_t>(addr) + bytes - begin + page - 1) / page;
+    const size_t stride = std::max<size_t>(1, pages / 4096);
+    std::vector<void*> samples;
+    for (size_t i = 0; i < pages; i += stride) samples.push_back(reinterpret_cast<void*>(begin + i * page));
+    std::vector<int> nodes(samples.size(), -1);
+    // move_pages(2) without target nodes only reports where each page is
+    if (::syscall(SYS_move_pages, 0, samples.size(), samples.data(), nullptr, nodes.data(), 0) != 0) return 1.0;
+    const int here = current_numa_node();
+    const auto local = std::count(nodes.begin(), nodes.end(), here);
+    return static_cast<double>(local) / static_cast<double>(samples.size());
+}
+
+size_t resident_bytes(long pid) {
+    std::ifstream statm(pid ? "/proc/" + std::to_string(pid) + "/statm" : std::string("/proc/self/statm"));
+    size_t size = 0;
+    size_t resident = 0;
+    if (!(statm >> size >> resident)) return 0;
+    return resident * static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+#else
+
+std::shared_ptr<char> allocate_placed(size_t bytes, const MemoryPlacement& placement) {
+    if (!placement.is_default()) warn("Huge pages and NUMA placement need Linux; using the heap");
+    return heap_block(bytes);
+}
+
+size_t numa_node_count() {
+    return 1;
+}
+
+int current_numa_node() {
+    return 0;
+}
+
+std::vector<int> numa_node_cpus(int) {
+    return {};
+}
+
+bool pin_to_numa_node(int) {
+    return false;
+}
+
+size_t huge_page_bytes(const void*) {
+    return 0;
+}
+
+double local_page_fraction(const void*, size_t) {
+    return 1.0;
+}
+
+size_t resident_bytes(long) {
+    return 0;
+}
+
+#endif
+
+} // namespace backtest
@@ -0,0 +1,99 @@
+#include "utils/perf_counters.h"
+
+#ifdef __linux__
+    #include <cstring>
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace backtest {
+
+const char* PerfCounters::name(Event event) {
+    switch (event) {
+        case Cycles: return "cycles";
+        case Instructions: return "instructions";
+        case L1DMisses: return "L1D misses";
+        case LLCMisses: return "LLC misses";
+        case DTLBMisses: return "dTLB misses";
+        case BranchMisses: return "branch misses";
+        case TaskClock: return "task clock ns";
+        default: return "?";
+    }
+}
+
+bool PerfCounters::any_hardware() const {
+    for (size_t e = 0; e < kEventCount; ++e) {
+        if (e != TaskClock && fds_[e] >= 0) return true;
+    }
+    return false;
+}
+
+#ifdef __linux__
+
+namespace {
+
+int open_event(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+constexpr uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    fds_[Cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds_[Instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[L1DMisses] = open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                                                 PERF_COUNT_HW_CACHE_RESULT_MISS));
+    fds_[LLCMisses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds_[DTLBMisses] = open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                                                  PERF_COUNT_HW_CACHE_RESULT_MISS));
+    fds_[BranchMisses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds_[TaskClock] = open_event(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds_) {
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+PerfCounters::Reading PerfCounters::read() const {
+    Reading reading;
+    for (size_t e = 0; e < kEventCount; ++e) {
+        if (fds_[e] < 0) continue;
+        uint64_t raw[3];  // value, time enabled, time running
+        if (::read(fds_[e], raw, sizeof(raw)) != static_cast<ssize_t>(sizeof(raw))) continue;
+        reading.values[e] = (raw[2] > 0 && raw[2] < raw[1])
+            ? static_cast<uint64_t>(static_cast<double>(raw[0]) * static_cast<double>(raw[1]) / static_cast<double>(raw[2]))
+            : raw[0];
+    }
+    return reading;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+PerfCounters::Reading PerfCounters::read() const {
+    return {};
+}
+
+#endif
+
+} // namespace backtest
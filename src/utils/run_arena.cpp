@@ -0,0 +1,53 @@
+#include "utils/run_arena.h"
+#include <vector>
+
+namespace backtest {
+
+namespace {
+
+constexpr size_t kMinBlockBytes = 64 * 1024;
+
+// Set once the thread's cache is destroyed; trivially destructible, so it
+// stays readable for arenas of engines that outlive it (statics at exit)
+thread_local bool cache_destroyed = false;
+
+// Blocks of finished runs on this thread, and the size the next one should have
+struct BlockCache {
+    std::vector<std::pair<std::unique_ptr<std::byte[]>, size_t>> free;
+    size_t wanted = kMinBlockBytes;
+    ~BlockCache() { cache_destroyed = true; }
+};
+
+BlockCache& block_cache() {
+    thread_local BlockCache cache;
+    return cache;
+}
+
+std::pair<std::unique_ptr<std::byte[]>, size_t> acquire_block() {
+    auto& cache = block_cache();
+    while (!cache.free.empty()) {
+        auto block = std::move(cache.free.back());
+        cache.free.pop_back();
+        if (block.second >= cache.wanted) return block;
+    }
+    return {std::make_unique<std::byte[]>(cache.wanted), cache.wanted};
+}
+
+} // namespace
+
+RunArena::RunArena()
+    : RunArena(acquire_block()) {}
+
+RunArena::RunArena(std::pair<std::unique_ptr<std::byte[]>, size_t> block)
+    : block_(std::move(block.first)), block_size_(block.second),
+      monotonic_(block_.get(), block_size_, &upstream_) {}
+
+RunArena::~RunArena() {
+    monotonic_.release();
+    if (cache_destroyed) return;
+    auto& cache = block_cache();
+    if (upstream_.bytes > 0) cache.wanted = std::max(cache.wanted, block_size_ + upstream_.bytes);
+    if (block_size_ >= cache.wanted) cache.free.emplace_back(std::move(block_), block_size_);
+}
+
+} // namespace backtest
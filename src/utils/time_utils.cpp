@@ -0,0 +1,101 @@
+#include "utils/time_utils.h"
+#include <cstdio>
+
+namespace backtest {
+namespace TimeUtils {
+
+namespace {
+
+// Parse exactly `count` digits at pos
+bool digits(std::string_view text, size_t pos, size_t count, int& value) {
+    if (pos + count > text.size()) return false;
+    value = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        if (text[i] < '0' || text[i] > '9') return false;
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+} // namespace
+
+std::string format_date(int64_t days) {
+    // civil_from_days
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+    char buffer[32];  // Room for any int64 year
+    std::snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02u", static_cast<long long>(year), month, day);
+    return buffer;
+}
+
+bool parse_date(std::string_view text, int64_t& days) {
+    int year, month, day;
+    if (!digits(text, 0, 4, year) || text.size() < 10 || text[4] != '-' || text[7] != '-' ||
+        !digits(text, 5, 2, month) || !digits(text, 8, 2, day) ||
+        month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    days = days_from_civil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    return true;
+}
+
+bool parse_timestamp(std::string_view text, int64_t& epoch_ns) {
+    int64_t days;
+    if (!parse_date(text, days)) return false;
+    int64_t ns = days * kNanosPerDay;
+    if (text.size() == 10) {
+        epoch_ns = ns;
+        return true;
+    }
+
+    int hours, minutes, seconds = 0;
+    if ((text[10] != ' ' && text[10] != 'T') || !digits(text, 11, 2, hours) ||
+        text.size() < 16 || text[13] != ':' || !digits(text, 14, 2, minutes)) {
+        return false;
+    }
+    size_t pos = 16;
+    if (pos < text.size() && text[pos] == ':') {
+        if (!digits(text, pos + 1, 2, seconds)) return false;
+        pos += 3;
+    }
+    ns += ((hours * 60LL + minutes) * 60LL + seconds) * 1000000000LL;
+    if (pos < text.size() && text[pos] == '.') {
+        int64_t fraction = 0, scale = 1000000000LL;
+        for (++pos; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos) {
+            if (scale > 1) {
+                scale /= 10;
+                fraction += (text[pos] - '0') * scale;
+            }
+        }
+        ns += fraction;
+    }
+
+    // Offset from UTC: local time minus offset is UTC
+    if (pos < text.size()) {
+        if (text[pos] == 'Z') {
+            ++pos;
+        } else if (text[pos] == '+' || text[pos] == '-') {
+            int offset_hours, offset_minutes = 0;
+            if (!digits(text, pos + 1, 2, offset_hours)) return false;
+            size_t minute_pos = pos + 3;
+            if (minute_pos < text.size() && text[minute_pos] == ':') ++minute_pos;
+            if (minute_pos < text.size() && !digits(text, minute_pos, 2, offset_minutes)) return false;
+            const int64_t offset = (offset_hours * 60LL + offset_minutes) * kNanosPerMinute;
+            ns += (text[pos] == '+') ? -offset : offset;
+            pos = minute_pos + (minute_pos < text.size() ? 2 : 0);
+        }
+    }
+    if (pos != text.size()) return false;
+    epoch_ns = ns;
+    return true;
+}
+
+} // namespace TimeUtils
+} // namespace backtest
@@ -0,0 +1,184 @@
+#include "utils/trace.h"
+#include "utils/memory_placement.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+    #include <process.h>
+    #define getpid _getpid
+#else
+    #include <unistd.h>
+#endif
+
+namespace backtest {
+
+namespace {
+
+struct Record {
+    const char* name;
+    int64_t start_ns;
+    int64_t value;  // Duration of a span, value of a counter
+    char phase;     // 'X' span, 'C' counter
+};
+
+struct ThreadBuffer {
+    std::vector<Record> records;
+    size_t next = 0;
+    bool wrapped = false;
+    uint32_t tid = 0;
+    std::string name;
+
+    void push(const Record& record) {
+        records[next] = record;
+        if (++next == records.size()) {
+            next = 0;
+            wrapped = true;
+        }
+    }
+};
+
+// Buffers live until exit, so a thread's cached pointer never dangles
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    size_t capacity = Trace::kDefaultEvents;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+ThreadBuffer& local_buffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto owned = std::make_unique<ThreadBuffer>();
+        owned->records.resize(reg.capacity);
+        owned->tid = static_cast<uint32_t>(reg.buffers.size() + 1);
+        owned->name = "thread " + std::to_string(owned->tid);
+        buffer = owned.get();
+        reg.buffers.push_back(std::move(owned));
+    }
+    return *buffer;
+}
+
+std::string escaped(const std::string& text) {
+    std::string out;
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        if (static_cast<unsigned char>(ch) >= 0x20) out += ch;
+    }
+    return out;
+}
+
+// One JSON object per line, without separators
+void write_events(std::ostream& out) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    const long pid = static_cast<long>(::getpid());
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    for (const auto& buffer : reg.buffers) {
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":\"" << escaped(buffer->name) << "\"}}\n";
+        const size_t count = buffer->wrapped ? buffer->records.size() : buffer->next;
+        const size_t first = buffer->wrapped ? buffer->next : 0;
+        for (size_t i = 0; i < count; ++i) {
+            const Record& r = buffer->records[(first + i) % buffer->records.size()];
+            out << "{\"name\":\"" << escaped(r.name) << "\",\"ph\":\"" << r.phase << "\",\"ts\":"
+                << static_cast<double>(r.start_ns) / 1000.0 << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid;
+            if (r.phase == 'X') out << ",\"dur\":" << static_cast<double>(r.value) / 1000.0 << "}\n";
+            else out << ",\"args\":{\"value\":" << r.value << "}}\n";
+        }
+    }
+}
+
+} // namespace
+
+void Trace::start(size_t events_per_thread) {
+    auto& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.capacity = std::max<size_t>(events_per_thread, 1);
+        for (auto& buffer : reg.buffers) {
+            buffer->records.assign(reg.capacity, Record{});
+            buffer->next = 0;
+            buffer->wrapped = false;
+        }
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Trace::set_thread_name(const std::string& name) {
+    auto& buffer = local_buffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name;
+}
+
+int64_t Trace::now_ns() {
+    // Monotonic and system-wide on Linux, so traces of several processes line up
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::complete(const char* name, int64_t start_ns, int64_t end_ns) {
+    local_buffer().push(Record{name, start_ns, end_ns - start_ns, 'X'});
+}
+
+void Trace::counter(const char* name, int64_t value) {
+    if (!enabled()) return;
+    local_buffer().push(Record{name, now_ns(), value, 'C'});
+}
+
+void Trace::memory_counter() {
+    if (!enabled()) return;
+    if (const size_t rss = resident_bytes()) counter("rss_bytes", static_cast<int64_t>(rss));
+}
+
+void Trace::write_json(const std::string& path) {
+    std::ostringstream events;
+    write_events(events);
+    const std::filesystem::path target(path);
+    const std::string prefix = target.filename().string() + ".";
+    std::error_code ec;
+    const auto dir = target.has_parent_path() ? target.parent_path() : std::filesystem::path(".");
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind(prefix, 0) != 0 || !name.ends_with(".part")) continue;
+        {
+            std::ifstream in(entry.path());
+            if (in.peek() != std::ifstream::traits_type::eof()) events << in.rdbuf();
+        }
+        std::filesystem::remove(entry.path(), ec);
+    }
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) throw std::runtime_error("Could not write trace: " + path);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    std::istringstream lines(events.str());
+    std::string line;
+    bool first = true;
+    while (std::getline(lines, line)) {
+        if (line.empty()) continue;
+        out << (first ? "" : ",\n") << line;
+        first = false;
+    }
+    out << "\n]}\n";
+}
+
+void Trace::write_fragment(const std::string& path) {
+    const std::string fragment = path + "." + std::to_string(static_cast<long>(::getpid())) + ".part";
+    std::ofstream out(fragment, std::ios::trunc);
+    if (!out.is_open()) throw std::runtime_error("Could not write trace fragment: " + fragment);
+    write_events(out);
+}
+
+} // namespace backtest
@@ -0,0 +1,127 @@
+import ctypes
+
+import backtest_engine as bt
+
+# Must match NEMO_NATIVE_ABI_VERSION and the structs in include/python/bindings.h
+ABI_VERSION = 1
+
+HOLD, BUY, SELL, CLOSE = 0, 1, 2, 3
+
+
+class NativeTick(ctypes.Structure):
+    """Mirror of NemoNativeTick"""
+    _fields_ = [
+        ("timestamp_ns", ctypes.c_int64),
+        ("bid_price", ctypes.c_double),
+        ("ask_price", ctypes.c_double),
+        ("last_price", ctypes.c_double),
+        ("open", ctypes.c_double),
+        ("high", ctypes.c_double),
+        ("low", ctypes.c_double),
+        ("close", ctypes.c_double),
+        ("volume", ctypes.c_uint64),
+        ("instrument_index", ctypes.c_uint32),
+        ("reserved", ctypes.c_uint32),
+    ]
+
+
+class NativeState(ctypes.Structure):
+    """Mirror of NemoNativeState"""
+    _fields_ = [
+        ("position", ctypes.c_double),
+        ("average_price", ctypes.c_double),
+        ("tick_count", ctypes.c_uint64),
+        ("user_state", ctypes.POINTER(ctypes.c_double)),
+        ("user_state_len", ctypes.c_uint32),
+        ("reserved", ctypes.c_uint32),
+    ]
+
+
+TICK_CALLBACK = ctypes.CFUNCTYPE(ctypes.c_int32, ctypes.POINTER(NativeTick),
+                                 ctypes.POINTER(NativeState))
+
+
+def attach(strategy_id: str, callback, state_slots: int = 0):
+    """Attach a compiled callback to a Python strategy.
+
+    `callback` may be a numba cfunc (its `.address` is used) or a ctypes
+    function built with TICK_CALLBACK. The caller must keep it alive for the
+    duration of the run. `state_slots` must cover what the callback reads
+    through `user_state`; callbacks that carry a `state_slots` attribute (as
+    returned by the make_* helpers) get at least that many.
+    """
+    required = getattr(callback, "state_slots", 0)
+    if state_slots < required:
+        raise ValueError("callback needs %d state slots, got %d" % (required, state_slots))
+    if bt.native_abi_version() != ABI_VERSION:
+        raise RuntimeError("native ABI mismatch: engine=%d module=%d"
+                           % (bt.native_abi_version(), ABI_VERSION))
+    address = getattr(callback, "address", None)
+    if address is None:
+        address = ctypes.cast(callback, ctypes.c_void_p).value
+    bt.attach_native(strategy_id, address, state_slots)
+
+
+class _Callback:
+    """Compiled callback plus the scratch it needs; keeps the cfunc alive"""
+
+    def __init__(self, cfunc, state_slots):
+        self.cfunc = cfunc
+        self.address = cfunc.address
+        self.state_slots = state_slots
+
+
+def make_ema_cross_cfunc(short_period: int = 12, long_period: int = 26):
+    """Example numba cfunc: EMA crossover on close, state = [ema_s, ema_l, long].
+
+    Attach with state_slots >= 3; the callback holds without enough scratch.
+    """
+    from numba import cfunc, carray, types
+
+    tick_t = types.Record.make_c_struct([
+        ("timestamp_ns", types.int64),
+        ("bid_price", types.float64),
+        ("ask_price", types.float64),
+        ("last_price", types.float64),
+        ("open", types.float64),
+        ("high", types.float64),
+        ("low", types.float64),
+        ("close", types.float64),
+        ("volume", types.uint64),
+        ("instrument_index", types.uint32),
+        ("reserved", types.uint32),
+    ])
+    state_t = types.Record.make_c_struct([
+        ("position", types.float64),
+        ("average_price", types.float64),
+        ("tick_count", types.uint64),
+        ("user_state", types.CPointer(types.float64)),
+        ("user_state_len", types.uint32),
+        ("reserved", types.uint32),
+    ])
+    STATE_SLOTS = 3
+    k_s = 2.0 / (short_period + 1)
+    k_l = 2.0 / (long_period + 1)
+
+    @cfunc(types.int32(types.CPointer(tick_t), types.CPointer(state_t)), nopython=True)
+    def on_tick(tick_ptr, state_ptr):
+        tick = carray(tick_ptr, 1)[0]
+        state = carray(state_ptr, 1)[0]
+        if state.user_state_len < STATE_SLOTS:
+            return HOLD
+        scratch = carray(state.user_state, STATE_SLOTS)
+        if state.tick_count == 0:
+            scratch[0] = tick.close
+            scratch[1] = tick.close
+            return HOLD
+        scratch[0] = tick.close * k_s + scratch[0] * (1.0 - k_s)
+        scratch[1] = tick.close * k_l + scratch[1] * (1.0 - k_l)
+        if scratch[2] == 0.0 and scratch[0] > scratch[1]:
+            scratch[2] = 1.0
+            return BUY
+        if scratch[2] == 1.0 and scratch[0] < scratch[1]:
+            scratch[2] = 0.0
+            return SELL
+        return HOLD
+
+    return _Callback(on_tick, STATE_SLOTS)
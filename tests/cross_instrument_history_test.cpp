@@ -0,0 +1,69 @@
+#include "core/engine.h"
+#include "strategy/strategy_base.h"
+#include "test_support.h"
+#include <vector>
+
+using namespace backtest;
+
+namespace {
+
+constexpr int64_t kMinutes = 200;
+
+// Closes carry the row's minute, so a value read back tells its row's time
+class PeekingStrategy : public StrategyBase {
+public:
+    PeekingStrategy() : StrategyBase("peek") {
+        subscribe("AAA");
+        subscribe("BBB");
+    }
+
+    void on_market_data(const MarketEvent& event) override {
+        const auto& tick = event.tick();
+        const double minute = tick.close;
+        const InstrumentId other = tick.instrument == "AAA" ? "BBB" : "AAA";
+        auto seen = history(other, Field::Close, 3);
+        auto volumes = volume_history(other, 3);
+        CHECK(seen.size() == volumes.size());
+        if (seen.empty()) {
+            // Only before the other instrument's first row
+            CHECK(minute < 1.0);
+            return;
+        }
+        ++peeks;
+        // Never later than the delivered tick, and nothing in between skipped
+        CHECK(seen.back() <= minute);
+        CHECK(seen.back() >= minute - 1.0);
+        CHECK(static_cast<double>(volumes.back()) == seen.back());
+    }
+
+    size_t peeks = 0;
+};
+
+std::vector<MarketDataTick> minutes_from(int64_t first) {
+    std::vector<MarketDataTick> ticks;
+    for (int64_t minute = first; minute < kMinutes; minute += 2) {
+        MarketDataTick tick;
+        tick.timestamp = Timestamp(std::chrono::minutes(minute));
+        tick.open = tick.high = tick.low = tick.close = tick.last_price = static_cast<double>(minute);
+        tick.volume = static_cast<Volume>(minute);
+        ticks.push_back(tick);
+    }
+    return ticks;
+}
+
+} // namespace
+
+int main() {
+    // AAA trades on even minutes and replays first; BBB on odd minutes
+    BacktestEngine engine;
+    engine.add_tick_data("AAA", minutes_from(0));
+    engine.add_tick_data("BBB", minutes_from(1));
+    auto strategy = std::make_unique<PeekingStrategy>();
+    auto* peeking = strategy.get();
+    engine.add_strategy(std::move(strategy));
+    engine.run();
+
+    // Every tick but AAA's first sees the other instrument
+    CHECK(peeking->peeks == static_cast<size_t>(kMinutes - 1));
+    return test_failures();
+}
@@ -0,0 +1,88 @@
+#include "core/engine.h"
+#include "distributed/sweep_coordinator.h"
+#include "strategy/strategy_base.h"
+#include "utils/config.h"
+#include "utils/logging.h"
+#include "test_support.h"
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace backtest;
+
+namespace {
+
+constexpr size_t kAll = std::numeric_limits<size_t>::max();
+
+std::unique_ptr<BacktestEngine> engine_for(const Config& config, const TickDataStore& store) {
+    auto engine = std::make_unique<BacktestEngine>();
+    engine->configure(config);
+    engine->use_data(store);
+    engine->add_strategy(StrategyFactory::create_from_config(config));
+    return engine;
+}
+
+void check_same(const BacktestEngine::BacktestResults& got, const BacktestEngine::BacktestResults& want) {
+    CHECK(got.total_trades == want.total_trades);
+    CHECK_NEAR(got.total_pnl, want.total_pnl, 1e-9);
+    CHECK(got.equity_curve.size() == want.equity_curve.size());
+    if (got.equity_curve.size() != want.equity_curve.size()) return;
+    for (size_t i = 0; i < got.equity_curve.size(); ++i) {
+        CHECK(got.equity_curve[i].time == want.equity_curve[i].time);
+        CHECK(got.equity_curve[i].pnl == want.equity_curve[i].pnl);
+    }
+}
+
+} // namespace
+
+// Forked replays against full runs: engine forks taken along the way, and
+// run_plan_forked against run_plan_entry over the sample sweep
+int main() {
+    Logger::get().set_level(LogLevel::WARN);
+    RunPlan plan = RunPlan::compile(Config::load_file("config/sample.toml"));
+    Config config = plan.config_for(0);
+    config.log_path.clear();
+
+    BacktestEngine loader;
+    loader.load_data(plan.base());
+    const TickDataStore& store = loader.get_data_store();
+
+    auto full = engine_for(config, store);
+    CHECK(full->start());
+    while (full->advance(kAll)) {}
+    full->finish();
+    const auto& want = full->get_results();
+    CHECK(want.total_trades > 0);
+    CHECK(want.equity_curve.size() > 1);
+
+    // Fork every few hundred ticks, as run_plan_forked does; the parent and
+    // forks of forks still end with the full run's curve
+    auto parent = engine_for(config, store);
+    CHECK(parent->start());
+    std::vector<std::unique_ptr<BacktestEngine>> forks;
+    while (parent->advance(300)) {
+        std::shared_ptr<const BacktestEngine> checkpoint = parent->fork();
+        if (forks.size() % 2 == 0) forks.push_back(checkpoint->fork());
+        else forks.push_back(forks.back()->fork());
+    }
+    parent->finish();
+    check_same(parent->get_results(), want);
+    CHECK(forks.size() > 2);
+    for (auto& fork : forks) {
+        while (fork->advance(kAll)) {}
+        fork->finish();
+        check_same(fork->get_results(), want);
+    }
+
+    std::vector<size_t> runs;
+    for (size_t run = 0; run < plan.run_count(); ++run) runs.push_back(run);
+    const auto forked = run_plan_forked(plan, runs, store, 64);
+    CHECK(forked.size() == runs.size());
+    for (const auto& result : forked) {
+        const SweepResult scalar = run_plan_entry(plan, result.run_index, store);
+        CHECK(result.status == 0);
+        CHECK(result.total_trades == scalar.total_trades);
+        CHECK_NEAR(result.total_pnl, scalar.total_pnl, 1e-6);
+    }
+    return test_failures();
+}
@@ -0,0 +1,78 @@
+#include "python/bindings.h"
+#include "test_support.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace backtest;
+namespace api = backtest::python::api;
+
+namespace {
+
+// Closes seen when the callback acted, and the positions it was shown then
+std::vector<double> acted_closes;
+std::vector<double> acted_positions;
+
+// Buys at ticks 10, 30 and 31, sells at 20 and flattens at 40; scratch slot 0 counts calls
+extern "C" int32_t scripted_callback(const NemoNativeTick* tick, NemoNativeState* state) {
+    if (state->user_state_len < 1) return 0;
+    state->user_state[0] += 1.0;
+    python::NativeAction action = python::NativeAction::HOLD;
+    switch (state->tick_count) {
+        case 10: case 30: case 31: action = python::NativeAction::BUY; break;
+        case 20: action = python::NativeAction::SELL; break;
+        case 40: action = python::NativeAction::CLOSE; break;
+        default: return 0;
+    }
+    acted_closes.push_back(tick->close);
+    acted_positions.push_back(state->position);
+    return static_cast<int32_t>(action);
+}
+
+// Reads scratch it was not given
+extern "C" int32_t greedy_callback(const NemoNativeTick*, NemoNativeState* state) {
+    if (state->user_state_len < 3 || !state->user_state) return 0;
+    return 1;
+}
+
+std::string zero_latency_config() {
+    const auto path = std::filesystem::temp_directory_path() / "nemo_native_callback_test.toml";
+    std::ofstream(path) << "[latency]\nmarket_data_us = 0\n";
+    return path.string();
+}
+
+} // namespace
+
+int main() {
+    // Callback trades reach positions and P&L through the API's engine
+    api::initialize_engine(zero_latency_config());
+    api::add_strategy_from_python("native", "unused_module");
+    api::attach_native_callback("native", reinterpret_cast<uintptr_t>(&scripted_callback), 1);
+    api::load_data_file("data/stock_data.csv");
+    api::run_backtest();
+
+    CHECK(acted_closes.size() == 5);
+    if (acted_closes.size() == 5) {
+        const double expected = (acted_closes[1] - acted_closes[0]) + 2.0 * acted_closes[4] - acted_closes[2] - acted_closes[3];
+        CHECK_NEAR(api::get_strategy_pnl("native"), expected, 1e-9);
+        CHECK_NEAR(api::get_total_pnl(), expected, 1e-9);
+        // The state shows the position before each action
+        CHECK(acted_positions[0] == 0.0);
+        CHECK(acted_positions[1] == 1.0);
+        CHECK(acted_positions[2] == 0.0);
+        CHECK(acted_positions[3] == 1.0);
+        CHECK(acted_positions[4] == 2.0);
+    }
+    CHECK(api::get_position("native", "stock_data") == 0.0);
+
+    // Without the scratch it asks for, a callback sees none and holds
+    api::initialize_engine(zero_latency_config());
+    api::add_strategy_from_python("greedy", "unused_module");
+    api::attach_native_callback("greedy", reinterpret_cast<uintptr_t>(&greedy_callback), 0);
+    api::load_data_file("data/stock_data.csv");
+    api::run_backtest();
+    CHECK(api::get_position("greedy", "stock_data") == 0.0);
+    CHECK(api::get_strategy_pnl("greedy") == 0.0);
+
+    return test_failures();
+}
@@ -0,0 +1,87 @@
+#include "core/engine.h"
+#include "strategy/strategy_base.h"
+#include "utils/logging.h"
+#include "test_support.h"
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace backtest;
+
+namespace {
+
+// Counted while set; the replay of one tick should not touch the heap
+bool counting = false;
+size_t allocations = 0;
+
+constexpr int64_t kMinutes = 3000;
+
+// Reads each tick, date included, and never trades
+class ReadingStrategy : public StrategyBase {
+public:
+    explicit ReadingStrategy(Duration conflation) : StrategyBase("reader") {
+        subscribe("LONG_INSTRUMENT_NAME");
+        set_conflation(conflation);
+    }
+
+    void on_market_data(const MarketEvent& event) override {
+        date_chars += event.tick().date.size();
+        ++seen;
+    }
+
+    size_t date_chars = 0;
+    size_t seen = 0;
+};
+
+std::vector<MarketDataTick> minutes() {
+    std::vector<MarketDataTick> ticks;
+    for (int64_t minute = 0; minute < kMinutes; ++minute) {
+        MarketDataTick tick;
+        tick.timestamp = Timestamp(std::chrono::minutes(minute));
+        tick.open = tick.high = tick.low = tick.close = tick.last_price = 100.0;
+        tick.volume = 1;
+        tick.date = "2025-05-12 09:15:00+05:30";  // Past the small-string buffer
+        ticks.push_back(tick);
+    }
+    return ticks;
+}
+
+// Allocations while replaying all but the first few hundred ticks
+size_t replay_allocations(Duration latency, Duration conflation) {
+    BacktestEngine engine;
+    engine.configure_latency(latency);
+    engine.add_tick_data("LONG_INSTRUMENT_NAME", minutes());
+    auto strategy = std::make_unique<ReadingStrategy>(conflation);
+    auto* reader = strategy.get();
+    engine.add_strategy(std::move(strategy));
+    CHECK(engine.start());
+    engine.advance(300);
+    allocations = 0;
+    counting = true;
+    while (engine.advance(1000)) {}
+    counting = false;
+    const size_t counted = allocations;
+    engine.finish();
+    CHECK(reader->seen > 0);
+    CHECK(reader->date_chars > 0);
+    return counted;
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (counting) ++allocations;
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+int main() {
+    Logger::get().set_level(LogLevel::WARN);
+    // Undelayed, delayed and conflated routes
+    CHECK(replay_allocations(Duration(0), Duration(0)) == 0);
+    CHECK(replay_allocations(std::chrono::seconds(90), Duration(0)) == 0);
+    CHECK(replay_allocations(std::chrono::seconds(30), std::chrono::minutes(5)) == 0);
+    return test_failures();
+}
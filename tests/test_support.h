@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+
+// Minimal checks for the *_test.cpp executables: failures are reported and
+// counted, and main() returns test_failures() so ctest sees them.
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if (!(condition)) {                                                                \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            ++test_failures();                                                             \
+        }                                                                                  \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                              \
+    do {                                                                                     \
+        const double check_actual_ = (actual);                                               \
+        const double check_expected_ = (expected);                                           \
+        if (!(std::fabs(check_actual_ - check_expected_) <= (tolerance))) {                  \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": " #actual " = " << check_actual_ \
+                      << ", expected " << check_expected_ << '\n';                           \
+            ++test_failures();                                                               \
+        }                                                                                    \
+    } while (0)